@@ -0,0 +1,253 @@
+/**
+ * @file Atomic.h
+ * @brief Portable Atomic Values
+ *
+ * Cores like the Cortex-M0 have no exclusive load/store, so std::atomic operations there
+ * become library calls (or don't link at all), and code shared with cores that do have
+ * them ends up with hand written critical sections around every counter. Atomic<T> uses
+ * std::atomic when it is lock-free for T, and a kernel critical section otherwise.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_ATOMIC_H_
+#define FREERTOSPP_ATOMIC_H_
+
+#include "FreeRTOScpp.h"
+#include <atomic>
+#include <type_traits>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#ifndef FREERTOSCPP_NATIVE_ATOMICS
+/**
+ * @def FREERTOSCPP_NATIVE_ATOMICS
+ * Define to 0 to make every Atomic use critical sections, for compilers that claim
+ * lock-free atomics the target can't actually do without a library.
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_NATIVE_ATOMICS  1
+#endif
+
+/**
+ * Which contexts an Atomic can be used from, so the critical section fallback can
+ * pick its masking.
+ * @ingroup FreeRTOSCpp
+ */
+enum AtomicMode {
+    Atomic_TaskOnly,    ///< Only used by tasks, falls back to taskENTER_CRITICAL().
+    Atomic_IsrSafe      ///< Shared with ISRs, falls back to taskENTER_CRITICAL_FROM_ISR(), which is also usable from tasks.
+};
+
+/**
+ * @brief Does std::atomic<T> always work without a lock on this target.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T> struct AtomicNative {
+    static constexpr bool value = FREERTOSCPP_NATIVE_ATOMICS && (
+        std::is_pointer<T>::value ? ATOMIC_POINTER_LOCK_FREE == 2 :
+        sizeof(T) == sizeof(char) ? ATOMIC_CHAR_LOCK_FREE == 2 :
+        sizeof(T) == sizeof(short) ? ATOMIC_SHORT_LOCK_FREE == 2 :
+        sizeof(T) == sizeof(int) ? ATOMIC_INT_LOCK_FREE == 2 :
+        sizeof(T) == sizeof(long) ? ATOMIC_LONG_LOCK_FREE == 2 :
+        sizeof(T) == sizeof(long long) ? ATOMIC_LLONG_LOCK_FREE == 2 :
+        false);
+};
+
+/**
+ * @brief Critical section used by the fallback Atomic.
+ */
+template<AtomicMode mode> class AtomicCritical;
+
+template<> class AtomicCritical<Atomic_TaskOnly> {
+public:
+    AtomicCritical() { taskENTER_CRITICAL(); }
+    ~AtomicCritical() { taskEXIT_CRITICAL(); }
+};
+
+template<> class AtomicCritical<Atomic_IsrSafe> {
+public:
+    AtomicCritical() : saved(taskENTER_CRITICAL_FROM_ISR()) {}
+    ~AtomicCritical() { taskEXIT_CRITICAL_FROM_ISR(saved); }
+private:
+    UBaseType_t saved;
+};
+
+/**
+ * @brief Portable Atomic Value.
+ *
+ * Has the operations of std::atomic (the fetch_ ones only for integral and pointer types).
+ * Where std::atomic<T> is lock-free this is just a std::atomic<T>, with every member inline,
+ * so compiles to the same code. Otherwise each operation is done inside a critical section,
+ * and the memory order arguments are ignored, as the critical section is a full barrier.
+ *
+ * Example Usage:
+ * @code
+ * Atomic<uint32_t, Atomic_IsrSafe> rxBytes;
+ *
+ * // In the ISR, or a task
+ * rxBytes.fetch_add(len, std::memory_order_relaxed);
+ * @endcode
+ *
+ * @tparam T        The type of the value.
+ * @tparam mode     The contexts the value is used from.
+ * @tparam native   Use std::atomic, defaults to if it is lock-free for T.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, AtomicMode mode = Atomic_TaskOnly, bool native = AtomicNative<T>::value>
+class Atomic {
+public:
+    Atomic() = default;
+    constexpr Atomic(T desired) : atom(desired) {}
+
+    T load(std::memory_order order = std::memory_order_seq_cst) const { return atom.load(order); }
+    void store(T desired, std::memory_order order = std::memory_order_seq_cst) { atom.store(desired, order); }
+    T exchange(T desired, std::memory_order order = std::memory_order_seq_cst) { return atom.exchange(desired, order); }
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) {
+        return atom.compare_exchange_strong(expected, desired, order);
+    }
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) {
+        return atom.compare_exchange_weak(expected, desired, order);
+    }
+    template<class U> T fetch_add(U arg, std::memory_order order = std::memory_order_seq_cst) { return atom.fetch_add(arg, order); }
+    template<class U> T fetch_sub(U arg, std::memory_order order = std::memory_order_seq_cst) { return atom.fetch_sub(arg, order); }
+    T fetch_and(T arg, std::memory_order order = std::memory_order_seq_cst) { return atom.fetch_and(arg, order); }
+    T fetch_or(T arg, std::memory_order order = std::memory_order_seq_cst) { return atom.fetch_or(arg, order); }
+    T fetch_xor(T arg, std::memory_order order = std::memory_order_seq_cst) { return atom.fetch_xor(arg, order); }
+
+    /**
+     * @brief Is the value handled without critical sections.
+     */
+    static constexpr bool isNative() { return true; }
+
+private:
+    std::atomic<T>  atom;
+
+#if __cplusplus < 201101L
+    Atomic(Atomic const&);      ///< We are not copyable.
+    void operator =(Atomic const&);  ///< We are not assignable.
+#else
+    Atomic(Atomic const&) = delete;      ///< We are not copyable.
+    void operator =(Atomic const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Portable Atomic Value, critical section version.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, AtomicMode mode>
+class Atomic<T, mode, false> {
+    typedef AtomicCritical<mode> Critical;
+public:
+    Atomic() = default;
+    constexpr Atomic(T desired) : val(desired) {}
+
+    T load(std::memory_order = std::memory_order_seq_cst) const {
+        Critical lock;
+        return val;
+    }
+    void store(T desired, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        val = desired;
+    }
+    T exchange(T desired, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        T old = val;
+        val = desired;
+        return old;
+    }
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        if(val == expected) {
+            val = desired;
+            return true;
+        }
+        expected = val;
+        return false;
+    }
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, desired, order);
+    }
+    template<class U> T fetch_add(U arg, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        T old = val;
+        val = old + arg;
+        return old;
+    }
+    template<class U> T fetch_sub(U arg, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        T old = val;
+        val = old - arg;
+        return old;
+    }
+    T fetch_and(T arg, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        T old = val;
+        val = old & arg;
+        return old;
+    }
+    T fetch_or(T arg, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        T old = val;
+        val = old | arg;
+        return old;
+    }
+    T fetch_xor(T arg, std::memory_order = std::memory_order_seq_cst) {
+        Critical lock;
+        T old = val;
+        val = old ^ arg;
+        return old;
+    }
+
+    /**
+     * @brief Is the value handled without critical sections.
+     */
+    static constexpr bool isNative() { return false; }
+
+private:
+    T   val;
+
+#if __cplusplus < 201101L
+    Atomic(Atomic const&);      ///< We are not copyable.
+    void operator =(Atomic const&);  ///< We are not assignable.
+#else
+    Atomic(Atomic const&) = delete;      ///< We are not copyable.
+    void operator =(Atomic const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_ATOMIC_H_ */
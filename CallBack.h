@@ -130,6 +130,9 @@ public:
 	void pendFromISR(uint32_t parm, BaseType_t* wasWoken) {
 		xTimerPendFunctionCallFromISR(&voidCallbackU32, this, parm, wasWoken);
 	}
+	void pendFromISR(uint32_t parm, IsrScope& isr) {
+		xTimerPendFunctionCallFromISR(&voidCallbackU32, this, parm, isr.ptr());
+	}
 #endif
 };
 
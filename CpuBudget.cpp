@@ -0,0 +1,191 @@
+/**
+ * @file CpuBudget.cpp
+ * @brief CPU Budget Enforcement for Tasks
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "CpuBudget.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if configGENERATE_RUN_TIME_STATS
+
+CpuBudget::CpuBudget(CpuBudgetEnforcerBase& enforcer_, TaskBase& task_, configRUN_TIME_COUNTER_TYPE budget_, TickType_t period_,
+                     CpuBudgetAction action_, CallBack<void, CpuBudget&>* handler_) :
+enforcer(enforcer_),
+managed(task_),
+allowed(budget_),
+replenishPeriod(period_),
+action(action_),
+handler(handler_),
+lastCounter(0),
+consumed(0),
+replenishAt(0),
+savedPriority(0),
+overrunCount(0),
+consuming(false),
+isThrottled(false),
+sampled(false),
+link(nullptr)
+{
+    taskENTER_CRITICAL();
+    link = enforcer.budgets;
+    enforcer.budgets = this;
+    enforcer.listVersion++;
+    taskEXIT_CRITICAL();
+}
+
+CpuBudget::~CpuBudget() {
+    taskENTER_CRITICAL();
+    CpuBudget** ptr = &enforcer.budgets;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    enforcer.listVersion++;
+    // If the enforcer is checking us right now, wait for it to finish.
+    while(enforcer.active == this) {
+        taskEXIT_CRITICAL();
+        vTaskDelay(1);
+        taskENTER_CRITICAL();
+    }
+    taskEXIT_CRITICAL();
+    if(isThrottled && managed.getTaskHandle()) release();
+}
+
+configRUN_TIME_COUNTER_TYPE CpuBudget::runTime(TaskHandle_t handle) {
+#if FREERTOS_VERSION_ALL >= 10'005'000
+    return ulTaskGetRunTimeCounter(handle);
+#else
+    TaskStatus_t status;
+    vTaskGetInfo(handle, &status, pdFALSE, eInvalid);
+    return status.ulRunTimeCounter;
+#endif
+}
+
+void CpuBudget::throttle() {
+    isThrottled = true;
+#if INCLUDE_vTaskSuspend
+    if(action == CpuBudget_Suspend) {
+        vTaskSuspend(managed.getTaskHandle());
+    } else
+#endif
+    {
+        // Not the inherited priority, or a mutex held now would leave the task boosted for good.
+        savedPriority = basePriority(managed.getTaskHandle());
+        vTaskPrioritySet(managed.getTaskHandle(), TaskPrio_Idle);
+    }
+}
+
+void CpuBudget::release() {
+    isThrottled = false;
+#if INCLUDE_vTaskSuspend
+    if(action == CpuBudget_Suspend) {
+        vTaskResume(managed.getTaskHandle());
+    } else
+#endif
+    {
+        vTaskPrioritySet(managed.getTaskHandle(), savedPriority);
+    }
+}
+
+void CpuBudget::check(TickType_t now) {
+    TaskHandle_t handle = managed.getTaskHandle();
+    // No task (yet), a null handle would have us sampling and throttling the enforcer.
+    if(!handle) return;
+    configRUN_TIME_COUNTER_TYPE counter = runTime(handle);
+    if(!sampled) {
+        // First sight of the task, just take the starting point.
+        sampled = true;
+        lastCounter = counter;
+        return;
+    }
+    configRUN_TIME_COUNTER_TYPE delta = counter - lastCounter;
+    lastCounter = counter;
+
+    // Sporadic replenishment, one period after consumption started.
+    if(consuming && !tickBefore(now, replenishAt)) {
+        consuming = false;
+        consumed = 0;
+        if(isThrottled) release();
+    }
+
+    if(delta) {
+        if(!consuming) {
+            consuming = true;
+            replenishAt = now + replenishPeriod;
+        }
+        consumed += delta;
+    }
+
+    if(!isThrottled && consumed >= allowed) {
+        overrunCount++;
+        throttle();
+        if(handler) handler->callback(*this);
+    }
+}
+
+void CpuBudgetEnforcerBase::check() {
+    TickType_t now = xTaskGetTickCount();
+    // Budgets are added and removed by other tasks, so walk the list locked, letting go only
+    // to check each budget (which changes task priorities and calls the handler). The budget
+    // being checked is marked active, so its destructor waits for us.
+    taskENTER_CRITICAL();
+    uint32_t version = listVersion;
+    CpuBudget* budget = budgets;
+    while(budget) {
+        active = budget;
+        taskEXIT_CRITICAL();
+        budget->check(now);
+        taskENTER_CRITICAL();
+        active = nullptr;
+        if(version != listVersion) {
+            // The list changed while unlocked, so budget may be gone. Start over, checking
+            // a budget twice just counts its run time in two parts.
+            version = listVersion;
+            budget = budgets;
+            continue;
+        }
+        budget = budget->link;
+    }
+    taskEXIT_CRITICAL();
+}
+
+#endif // configGENERATE_RUN_TIME_STATS
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
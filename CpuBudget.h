@@ -0,0 +1,246 @@
+/**
+ * @file CpuBudget.h
+ * @brief CPU Budget Enforcement for Tasks
+ *
+ * Limits how much CPU time a task can use in a period, so a misbehaving background task
+ * can only cause bounded interference to the tasks below it. Uses the run time stats
+ * counters, so requires configGENERATE_RUN_TIME_STATS.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_CPUBUDGET_H_
+#define FREERTOSPP_CPUBUDGET_H_
+
+#include "FreeRTOScpp.h"
+#include "CallBack.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if configGENERATE_RUN_TIME_STATS
+
+class CpuBudgetEnforcerBase;
+
+/**
+ * What to do with a task that has used up its budget.
+ * @ingroup FreeRTOSCpp
+ */
+enum CpuBudgetAction {
+    CpuBudget_Demote,       ///< Drop the task to TaskPrio_Idle until replenished
+    CpuBudget_Suspend       ///< Suspend the task until replenished (needs INCLUDE_vTaskSuspend)
+};
+
+/**
+ * @brief CPU Budget for a Task.
+ *
+ * The task is allowed to use budget units of the run time stats counter each period.
+ * Replenishment follows sporadic server rules: the budget is restored one period after
+ * the task started consuming it, rather than on fixed period boundaries, so the
+ * interference to other tasks is bounded in any window of one period.
+ *
+ * When the budget is used up, the task is demoted to TaskPrio_Idle (or suspended) until
+ * the replenishment, the overrun is counted, and the overrun handler (if any) called from
+ * the enforcer task.
+ *
+ * Consumption is sampled by the enforcer each check period, so a task may run up to one
+ * check period past its budget before being throttled.
+ *
+ * On demotion, the priority restored is the base priority the task had when it was
+ * demoted, not one inherited from a mutex it held then.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class CpuBudget {
+    friend class CpuBudgetEnforcerBase;
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param enforcer_ The enforcer that will monitor the task.
+     * @param task_ The task to limit. It need not exist yet (like a LazyTask not yet started,
+     * or a task in another file not yet constructed), it is left alone while it has no handle,
+     * and its run time is counted from the first check after it appears.
+     * @param budget_ The run time counter units allowed each period.
+     * @param period_ The replenishment period in ticks.
+     * @param action_ What to do when the budget is used up.
+     * @param handler_ Optional handler called on each overrun.
+     */
+    CpuBudget(CpuBudgetEnforcerBase& enforcer_, TaskBase& task_, configRUN_TIME_COUNTER_TYPE budget_, TickType_t period_,
+              CpuBudgetAction action_ = CpuBudget_Demote, CallBack<void, CpuBudget&>* handler_ = nullptr);
+    /**
+     * @brief Destructor
+     *
+     * Removes the budget, and releases the task if it is throttled. If the enforcer is
+     * checking the budget, waits for it to finish, so must not be called from the handler.
+     */
+    virtual ~CpuBudget();
+
+    TaskBase&       task() const { return managed; }
+    configRUN_TIME_COUNTER_TYPE budget() const { return allowed; }
+    TickType_t      period() const { return replenishPeriod; }
+    /**
+     * @brief Run time used since the current budget period started.
+     */
+    configRUN_TIME_COUNTER_TYPE used() const { return consumed; }
+    /**
+     * @brief Is the task currently throttled for using its budget.
+     */
+    bool            throttled() const { return isThrottled; }
+    /**
+     * @brief Number of times the task has used up its budget.
+     */
+    uint32_t        overruns() const { return overrunCount; }
+
+    /**
+     * @brief Get the run time counter of a task.
+     */
+    static configRUN_TIME_COUNTER_TYPE runTime(TaskHandle_t handle);
+
+private:
+    /// Update from the run time counter, called by the enforcer.
+    void check(TickType_t now);
+    void throttle();
+    void release();
+
+    CpuBudgetEnforcerBase&      enforcer;
+    TaskBase&                   managed;
+    configRUN_TIME_COUNTER_TYPE allowed;
+    TickType_t                  replenishPeriod;
+    CpuBudgetAction             action;
+    CallBack<void, CpuBudget&>* handler;
+
+    configRUN_TIME_COUNTER_TYPE lastCounter;
+    configRUN_TIME_COUNTER_TYPE consumed;
+    TickType_t                  replenishAt;
+    UBaseType_t                 savedPriority;
+    uint32_t                    overrunCount;
+    bool                        consuming;      ///< Consumption has started, replenishAt is valid
+    bool                        isThrottled;
+    bool                        sampled;        ///< lastCounter has been taken from the task
+    CpuBudget*                  link;
+
+#if __cplusplus < 201101L
+    CpuBudget(CpuBudget const&);      ///< We are not copyable.
+    void operator =(CpuBudget const&);  ///< We are not assignable.
+#else
+    CpuBudget(CpuBudget const&) = delete;      ///< We are not copyable.
+    void operator =(CpuBudget const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Enforces the CpuBudgets registered with it.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class CpuBudgetEnforcerBase {
+    friend class CpuBudget;
+public:
+    CpuBudgetEnforcerBase() : budgets(nullptr), active(nullptr), listVersion(0) {}
+    virtual ~CpuBudgetEnforcerBase() {}
+
+    /**
+     * @brief Sample all the budgets, and throttle or release the tasks.
+     */
+    void check();
+
+private:
+    CpuBudget*  budgets;
+    CpuBudget* volatile active;     ///< Budget being checked, outside the critical section.
+    uint32_t    listVersion;        ///< Bumped on each change to budgets, so check() knows to start over.
+
+#if __cplusplus < 201101L
+    CpuBudgetEnforcerBase(CpuBudgetEnforcerBase const&);      ///< We are not copyable.
+    void operator =(CpuBudgetEnforcerBase const&);  ///< We are not assignable.
+#else
+    CpuBudgetEnforcerBase(CpuBudgetEnforcerBase const&) = delete;      ///< We are not copyable.
+    void operator =(CpuBudgetEnforcerBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief CPU Budget Enforcer Task.
+ *
+ * Needs to run at a higher priority than the tasks it is limiting.
+ *
+ * Example Usage:
+ * @code
+ * CpuBudgetEnforcer<200> enforcer("Budget", TaskPrio_Highest, pdMS_TO_TICKS(5));
+ * TaskS<512> logger("Logger", &loggerTask, TaskPrio_Mid);
+ * // Allow 2 ms of each 20 ms, with a 1 MHz run time stats clock
+ * CpuBudget loggerBudget(enforcer, logger, 2000, pdMS_TO_TICKS(20));
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth>
+class CpuBudgetEnforcer : public TaskClassS<stackDepth>, public CpuBudgetEnforcerBase {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task, above the tasks being limited.
+     * @param checkPeriod_ How often to sample the tasks, in ticks.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    CpuBudgetEnforcer(char const* name, TaskPriority priority_, TickType_t checkPeriod_, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_),
+        checkPeriod(checkPeriod_ ? checkPeriod_ : 1)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    void task() override {
+        TickType_t last = xTaskGetTickCount();
+        while(1) {
+            TaskBase::delayUntil(last, checkPeriod);
+            check();
+        }
+    }
+
+private:
+    TickType_t  checkPeriod;
+};
+
+#endif // configGENERATE_RUN_TIME_STATS
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_CPUBUDGET_H_ */
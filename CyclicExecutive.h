@@ -0,0 +1,227 @@
+/**
+ * @file CyclicExecutive.h
+ * @brief Time Triggered Cyclic Executive
+ *
+ * Runs a fixed, compile time checked, table of jobs at set offsets in a repeating
+ * major frame, for control loops that want a static schedule rather than priority
+ * preemption between the jobs.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_CYCLICEXECUTIVE_H_
+#define FREERTOSPP_CYCLICEXECUTIVE_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+#include <stddef.h>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Entry in a CyclicExecutive schedule.
+ * @ingroup FreeRTOSCpp
+ */
+struct CyclicJob {
+    unsigned    frame;      ///< Minor frame (within the major frame) the job runs in.
+    TickType_t  offset;     ///< Release time, in ticks from the start of the minor frame.
+    void      (*job)();     ///< The job to run.
+    TickType_t  wcet;       ///< Worst case execution time allowed, in ticks.
+};
+
+/**
+ * @brief Compile time checks of CyclicExecutive schedules
+ * @ingroup FreeRTOSCpp
+ */
+namespace CyclicCheck {
+    /// All jobs are in a frame of the major frame.
+    constexpr bool framesValid(CyclicJob const* table, size_t count, unsigned minorFrames) {
+        for(size_t i = 0; i < count; i++) {
+            if(table[i].frame >= minorFrames) return false;
+        }
+        return true;
+    }
+    /// Jobs are sorted by frame and then offset.
+    constexpr bool sorted(CyclicJob const* table, size_t count) {
+        for(size_t i = 1; i < count; i++) {
+            if(table[i].frame < table[i-1].frame) return false;
+            if(table[i].frame == table[i-1].frame && table[i].offset < table[i-1].offset) return false;
+        }
+        return true;
+    }
+    /// Each job finishes (offset + wcet) before the end of its frame.
+    constexpr bool fits(CyclicJob const* table, size_t count, TickType_t minorTicks) {
+        for(size_t i = 0; i < count; i++) {
+            if(table[i].offset + table[i].wcet > minorTicks) return false;
+        }
+        return true;
+    }
+    /// A job isn't released before the previous job in its frame is allowed to finish.
+    constexpr bool noOverlap(CyclicJob const* table, size_t count) {
+        for(size_t i = 1; i < count; i++) {
+            if(table[i].frame == table[i-1].frame && table[i].offset < table[i-1].offset + table[i-1].wcet) return false;
+        }
+        return true;
+    }
+    /// Every job has a function.
+    constexpr bool haveJobs(CyclicJob const* table, size_t count) {
+        for(size_t i = 0; i < count; i++) {
+            if(table[i].job == nullptr) return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Time Triggered Cyclic Executive.
+ *
+ * Runs a static schedule of jobs from a single task. Time is divided into minor frames of
+ * minorTicks ticks, and minorFrames minor frames make up the major frame, which repeats.
+ * Each job is released at a fixed offset from the start of its minor frame, using
+ * delayUntil() from the frame start, so the release times don't drift and have no jitter
+ * beyond the tick resolution.
+ *
+ * The schedule is checked at compile time, jobs must be sorted by frame then offset, and
+ * each job's wcet must fit before the next job and the end of its frame.
+ *
+ * If a job runs past its wcet it is counted as a job overrun, and if a frame runs past
+ * its end it is counted as a frame overrun. Late frames are run as soon as possible to
+ * catch up, unless a whole major frame behind, when the frame timing is resynced to now.
+ *
+ * Example Usage:
+ * @code
+ * void readSensors();
+ * void control();
+ * void logData();
+ *
+ * constexpr CyclicJob schedule[] = {
+ *     { 0, 0, &readSensors, 1 },
+ *     { 0, 1, &control, 2 },
+ *     { 1, 0, &readSensors, 1 },
+ *     { 1, 1, &control, 2 },
+ *     { 1, 3, &logData, 2 },
+ * };
+ *
+ * // 5 tick minor frames, 2 per major frame.
+ * CyclicExecutive<256, 5, 2, sizeof(schedule)/sizeof(schedule[0]), schedule> executive("Cyclic", TaskPrio_Highest);
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task.
+ * @tparam minorTicks Length of a minor frame in ticks.
+ * @tparam minorFrames Number of minor frames in the major frame.
+ * @tparam jobCount Number of jobs in the table.
+ * @tparam table The schedule, a constexpr array of CyclicJob.
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth, TickType_t minorTicks, unsigned minorFrames, size_t jobCount, CyclicJob const (&table)[jobCount]>
+class CyclicExecutive : public TaskClassS<stackDepth> {
+    static_assert(minorTicks > 0, "Minor frame must be at least one tick");
+    static_assert(minorFrames > 0, "Need at least one minor frame");
+    static_assert(CyclicCheck::framesValid(table, jobCount, minorFrames), "Job frame past the end of the major frame");
+    static_assert(CyclicCheck::sorted(table, jobCount), "Jobs must be sorted by frame and offset");
+    static_assert(CyclicCheck::fits(table, jobCount, minorTicks), "Job doesn't fit in its frame");
+    static_assert(CyclicCheck::noOverlap(table, jobCount), "Job released before the previous job's wcet");
+    static_assert(CyclicCheck::haveJobs(table, jobCount), "Job without a function");
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    CyclicExecutive(char const* name, TaskPriority priority_, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_),
+        frameOverrunCount(0),
+        jobOverrunCount(0),
+        majorCount(0)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    /**
+     * @brief Number of minor frames that ran past their end.
+     */
+    uint32_t frameOverruns() const { return frameOverrunCount; }
+    /**
+     * @brief Number of jobs that ran past their wcet.
+     */
+    uint32_t jobOverruns() const { return jobOverrunCount; }
+    /**
+     * @brief Number of major frames completed.
+     */
+    uint32_t majorFrames() const { return majorCount; }
+
+    void task() override {
+        TickType_t frameStart = xTaskGetTickCount();
+        while(1) {
+            size_t idx = 0;
+            for(unsigned frame = 0; frame < minorFrames; frame++) {
+                for(; idx < jobCount && table[idx].frame == frame; idx++) {
+                    CyclicJob const& job = table[idx];
+                    if(job.offset) {
+                        TickType_t release = frameStart;
+                        TaskBase::delayUntil(release, job.offset);
+                    }
+                    (*job.job)();
+                    if(static_cast<TickType_t>(xTaskGetTickCount() - frameStart) > job.offset + job.wcet) {
+                        jobOverrunCount++;
+                    }
+                }
+                TickType_t elapsed = xTaskGetTickCount() - frameStart;
+                if(elapsed > minorTicks) {
+                    frameOverrunCount++;
+                    if(elapsed >= minorTicks * minorFrames) {
+                        // A whole major frame behind, resync the frame timing to now.
+                        frameStart = xTaskGetTickCount() - minorTicks;
+                    }
+                }
+                TaskBase::delayUntil(frameStart, minorTicks);
+            }
+            majorCount++;
+        }
+    }
+
+private:
+    uint32_t    frameOverrunCount;
+    uint32_t    jobOverrunCount;
+    uint32_t    majorCount;
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_CYCLICEXECUTIVE_H_ */
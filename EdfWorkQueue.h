@@ -0,0 +1,367 @@
+/**
+ * @file EdfWorkQueue.h
+ * @brief Earliest Deadline First Work Queue
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_EDFWORKQUEUE_H_
+#define FREERTOSPP_EDFWORKQUEUE_H_
+
+#include "FreeRTOScpp.h"
+#include "SemaphoreCPP.h"
+#include "task.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Worker state for an EdfWorkQueue.
+ *
+ * Each worker task pulling from an EdfWorkQueue has one of these, to remember the
+ * priority it had before the queue boosted it for an urgent job.
+ *
+ * The boost is removed by done(), the next pop() or the destructor.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class EdfWorker {
+public:
+    EdfWorker() : savedPriority(0), boosted(false) {}
+    ~EdfWorker() { done(); }
+
+    /**
+     * @brief Finished with the current job, drop any priority boost.
+     */
+    void done() {
+        if(boosted) {
+            boosted = false;
+            vTaskPrioritySet(nullptr, savedPriority);
+        }
+    }
+
+    /**
+     * @brief Is the worker currently running at a boosted priority.
+     */
+    bool isBoosted() const { return boosted; }
+
+    /**
+     * @brief Raise the priority of the worker for an urgent job.
+     * @param priority The priority to raise to, ignored if we are already at or above it.
+     *
+     * Compares and saves our base priority, so one inherited from a mutex isn't restored.
+     */
+    void boost(UBaseType_t priority) {
+        if(boosted) return;
+        UBaseType_t current = basePriority(nullptr);
+        if(current < priority) {
+            savedPriority = current;
+            boosted = true;
+            vTaskPrioritySet(nullptr, priority);
+        }
+    }
+
+private:
+    UBaseType_t savedPriority;
+    bool        boosted;
+
+#if __cplusplus < 201101L
+    EdfWorker(EdfWorker const&);      ///< We are not copyable.
+    void operator =(EdfWorker const&);  ///< We are not assignable.
+#else
+    EdfWorker(EdfWorker const&) = delete;      ///< We are not copyable.
+    void operator =(EdfWorker const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Earliest Deadline First Work Queue.
+ *
+ * Like a Queue, but each job is given an absolute deadline (in ticks), and pop always
+ * returns the job with the earliest deadline. Jobs whose deadline has already passed when
+ * they reach the head are dropped and counted, see dropped().
+ *
+ * If the job popped is due within the urgency window, the worker is raised to the
+ * boost priority until it is done with the job, so urgent work isn't delayed by
+ * middle priority tasks.
+ *
+ * Jobs are kept in a binary heap of slot indexes, so push and pop are O(log length).
+ * Items are copied in and out inside a critical section (as the kernel does for Queues)
+ * so T should be small, pointers or small structs.
+ *
+ * Example Usage:
+ * @code
+ * EdfWorkQueue<Job*, 16> jobs(pdMS_TO_TICKS(5), TaskPrio_High);
+ *
+ * // Producer
+ * jobs.push(job, xTaskGetTickCount() + pdMS_TO_TICKS(20));
+ *
+ * // Worker Task
+ * EdfWorker worker;
+ * Job* job;
+ * while(jobs.pop(worker, job)) {
+ *    job->run();
+ *    worker.done();
+ * }
+ * @endcode
+ *
+ * @tparam T The type of the jobs.
+ * @tparam length The maximum number of jobs in the queue.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned length>
+class EdfWorkQueue {
+    static_assert(length > 0, "EdfWorkQueue needs a length");
+public:
+    /**
+     * @brief Constructor
+     * @param urgentWindow_ Jobs due within this many ticks when popped cause a priority boost.
+     * @param boostPriority_ The priority to boost the worker to.
+     * @param name The name for the jobs semaphore, used for the Debug Registry if setup.
+     */
+    EdfWorkQueue(TickType_t urgentWindow_ = 0, UBaseType_t boostPriority_ = 0, char const* name = nullptr) :
+        jobs(length, 0, name),
+        spaces(length, length),     // Unnamed, so the registry has one entry per queue
+        urgentWindow(urgentWindow_),
+        boostPriority(boostPriority_),
+        count(0),
+        droppedCount(0)
+    {
+        for(unsigned i = 0; i < length; i++) {
+            heap[i] = i;
+        }
+    }
+
+    /**
+     * @brief Add a job to the queue.
+     *
+     * @param item The job to add.
+     * @param deadline The absolute tick count the job needs to be done by.
+     * @param wait How long to wait for space in the queue.
+     * @return true if the job was added.
+     */
+    bool push(T const& item, TickType_t deadline, TickType_t wait = portMAX_DELAY) {
+        if(!spaces.take(wait)) return false;
+        taskENTER_CRITICAL();
+        insert(item, deadline);
+        taskEXIT_CRITICAL();
+        jobs.give();
+        return true;
+    }
+
+#if FREERTOSCPP_USE_CHRONO
+    /**
+     * @brief Add a job to the queue.
+     *
+     * @param item The job to add.
+     * @param deadline The absolute tick count the job needs to be done by.
+     * @param wait How long to wait for space in the queue.
+     * @return true if the job was added.
+     */
+    bool push(T const& item, TickType_t deadline, Time_ms wait) {
+        return push(item, deadline, ms2ticks(wait));
+    }
+#endif
+
+    /**
+     * @brief Add a job to the queue from an ISR.
+     *
+     * @param item The job to add.
+     * @param deadline The absolute tick count the job needs to be done by.
+     * @param waswoken Flag to indicate if a task was woken that needs a yield.
+     * @return true if the job was added.
+     */
+    bool push_ISR(T const& item, TickType_t deadline, portBASE_TYPE& waswoken) {
+        if(!spaces.take_ISR(waswoken)) return false;
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        insert(item, deadline);
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        jobs.give_ISR(waswoken);
+        return true;
+    }
+
+    /**
+     * @brief Get the job with the earliest deadline.
+     *
+     * Jobs that are already past their deadline are dropped.
+     * Any boost from the worker's previous job is removed first, and if the
+     * new job is urgent, the worker is boosted.
+     *
+     * @param worker The state for the calling worker task.
+     * @param item Where to put the job.
+     * @param wait How long to wait for a job.
+     * @param deadline If not null, where to put the deadline of the job.
+     * @return true if a job was returned.
+     */
+    bool pop(EdfWorker& worker, T& item, TickType_t wait = portMAX_DELAY, TickType_t* deadline = nullptr) {
+        worker.done();
+        TickType_t start = xTaskGetTickCount();
+        TickType_t remaining = wait;
+        while(jobs.take(remaining)) {
+            TickType_t now = xTaskGetTickCount();
+            TickType_t due;
+            bool stale;
+            taskENTER_CRITICAL();
+            due = remove(item);
+            stale = tickBefore(due, now);
+            if(stale) droppedCount++;
+            taskEXIT_CRITICAL();
+            spaces.give();
+
+            if(!stale) {
+                if(deadline) *deadline = due;
+                if(boostPriority && (due - now) <= urgentWindow) {
+                    worker.boost(boostPriority);
+                }
+                return true;
+            }
+            if(wait != portMAX_DELAY) {
+                TickType_t used = now - start;
+                remaining = used < wait ? wait - used : 0;
+            }
+        }
+        return false;
+    }
+
+#if FREERTOSCPP_USE_CHRONO
+    /**
+     * @brief Get the job with the earliest deadline.
+     *
+     * @param worker The state for the calling worker task.
+     * @param item Where to put the job.
+     * @param wait How long to wait for a job.
+     * @param deadline If not null, where to put the deadline of the job.
+     * @return true if a job was returned.
+     */
+    bool pop(EdfWorker& worker, T& item, Time_ms wait, TickType_t* deadline = nullptr) {
+        return pop(worker, item, ms2ticks(wait), deadline);
+    }
+#endif
+
+    /**
+     * @brief Get the deadline of the head job.
+     * @param deadline Where to put the deadline.
+     * @return false if the queue is empty.
+     */
+    bool peekDeadline(TickType_t& deadline) const {
+        bool ok;
+        taskENTER_CRITICAL();
+        ok = count > 0;
+        if(ok) deadline = slots[heap[0]].deadline;
+        taskEXIT_CRITICAL();
+        return ok;
+    }
+
+    /**
+     * @brief Number of jobs waiting.
+     */
+    unsigned waiting() const { return count; }
+
+    /**
+     * @brief Number of free spaces.
+     */
+    unsigned available() const { return length - count; }
+
+    /**
+     * @brief Number of jobs dropped for being past their deadline.
+     */
+    uint32_t dropped() const { return droppedCount; }
+
+private:
+    /// Must be called in a critical section, with a space reserved.
+    void insert(T const& item, TickType_t deadline) {
+        unsigned pos = count++;
+        unsigned slot = heap[pos];       // Unused slots are kept past the end of the heap.
+        slots[slot].item = item;
+        slots[slot].deadline = deadline;
+        while(pos > 0) {
+            unsigned parent = (pos - 1) / 2;
+            if(!tickBefore(deadline, slots[heap[parent]].deadline)) break;
+            heap[pos] = heap[parent];
+            pos = parent;
+        }
+        heap[pos] = slot;
+    }
+
+    /// Must be called in a critical section, with a job reserved.
+    TickType_t remove(T& item) {
+        unsigned slot = heap[0];
+        item = slots[slot].item;
+        TickType_t due = slots[slot].deadline;
+
+        unsigned last = heap[--count];
+        heap[count] = slot;             // Freed slot goes past the end of the heap.
+        if(count > 0) {
+            TickType_t lastDue = slots[last].deadline;
+            unsigned pos = 0;
+            while(1) {
+                unsigned child = 2 * pos + 1;
+                if(child >= count) break;
+                if(child + 1 < count && tickBefore(slots[heap[child + 1]].deadline, slots[heap[child]].deadline)) {
+                    child++;
+                }
+                if(!tickBefore(slots[heap[child]].deadline, lastDue)) break;
+                heap[pos] = heap[child];
+                pos = child;
+            }
+            heap[pos] = last;
+        }
+        return due;
+    }
+
+    struct Slot {
+        T           item;
+        TickType_t  deadline;
+    };
+
+    CountingSemaphore   jobs;       ///< Counts the jobs in the heap
+    CountingSemaphore   spaces;     ///< Counts the free slots
+    TickType_t          urgentWindow;
+    UBaseType_t         boostPriority;
+    unsigned            count;
+    uint32_t            droppedCount;
+    unsigned            heap[length];
+    Slot                slots[length];
+
+#if __cplusplus < 201101L
+    EdfWorkQueue(EdfWorkQueue const&);      ///< We are not copyable.
+    void operator =(EdfWorkQueue const&);  ///< We are not assignable.
+#else
+    EdfWorkQueue(EdfWorkQueue const&) = delete;      ///< We are not copyable.
+    void operator =(EdfWorkQueue const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_EDFWORKQUEUE_H_ */
@@ -0,0 +1,257 @@
+/**
+ * @file EventLoop.cpp
+ * @brief Reactor style Event Loop Task
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "EventLoop.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+// The lists of all the sources and timers, for every loop. Being zero initialized, they are
+// ready before any constructor runs.
+static EventSource* sourceList;
+static LoopTimer*   timerList;
+// Bumped on each change to the lists, so a walk that let go of the lock knows to start over.
+static uint32_t     listVersion;
+
+EventSource::EventSource(EventLoopBase& loop_) :
+loop(loop_),
+sourceBit(0),
+link(nullptr)
+{
+    taskENTER_CRITICAL();
+    // Lowest free bit, the top bit is for the timers.
+    uint32_t used = EventLoopBase::TimerBit;
+    for(EventSource* source = sourceList; source; source = source->link) {
+        if(&source->loop == &loop) used |= source->sourceBit;
+    }
+    uint32_t free = ~used;
+    configASSERT(free != 0);
+    sourceBit = free & (~free + 1);
+    // Add to the end, so sources are checked in the order registered.
+    EventSource** ptr = &sourceList;
+    while(*ptr) ptr = &(*ptr)->link;
+    *ptr = this;
+    listVersion++;
+    taskEXIT_CRITICAL();
+}
+
+EventSource::~EventSource() {
+    taskENTER_CRITICAL();
+    EventSource** ptr = &sourceList;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    listVersion++;
+    taskEXIT_CRITICAL();
+}
+
+void EventSource::notify() {
+    // The loop might not be constructed yet, and checks everything when it starts anyway.
+    if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) return;
+    loop.post(sourceBit);
+}
+
+void EventSource::notify_ISR(portBASE_TYPE& waswoken) {
+    loop.post_ISR(sourceBit, waswoken);
+}
+
+LoopTimer::LoopTimer(EventLoopBase& loop_, CallBack<void>& handler_, TickType_t period_, bool reload_) :
+loop(loop_),
+handler(handler_),
+timerPeriod(period_),
+expiry(0),
+reload(reload_),
+running(false),
+link(nullptr)
+{
+    taskENTER_CRITICAL();
+    LoopTimer** ptr = &timerList;
+    while(*ptr) ptr = &(*ptr)->link;
+    *ptr = this;
+    listVersion++;
+    taskEXIT_CRITICAL();
+}
+
+LoopTimer::~LoopTimer() {
+    taskENTER_CRITICAL();
+    LoopTimer** ptr = &timerList;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    listVersion++;
+    taskEXIT_CRITICAL();
+}
+
+void LoopTimer::start() {
+    taskENTER_CRITICAL();
+    expiry = xTaskGetTickCount() + timerPeriod;
+    running = true;
+    taskEXIT_CRITICAL();
+    if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) loop.post(EventLoopBase::TimerBit);
+}
+
+void LoopTimer::start(TickType_t period_) {
+    taskENTER_CRITICAL();
+    timerPeriod = period_;
+    taskEXIT_CRITICAL();
+    start();
+}
+
+void LoopTimer::stop() {
+    taskENTER_CRITICAL();
+    running = false;
+    taskEXIT_CRITICAL();
+}
+
+TickType_t EventLoopBase::runTimers() {
+    TickType_t next = portMAX_DELAY;
+    taskENTER_CRITICAL();
+    uint32_t version = listVersion;
+    LoopTimer* timer = timerList;
+    while(timer) {
+        if(&timer->loop != this) {
+            timer = timer->link;
+            continue;
+        }
+        TickType_t now = xTaskGetTickCount();
+        if(timer->running) {
+            TickType_t remaining = timer->expiry - now;
+            if(remaining == 0 || remaining > timer->timerPeriod) {
+                // Expired (remaining wraps to a big value once past the expiry)
+                if(timer->reload && timer->timerPeriod) {
+                    timer->expiry += timer->timerPeriod;
+                    if(static_cast<TickType_t>(timer->expiry - now) > timer->timerPeriod) {
+                        timer->expiry = now + timer->timerPeriod;   // Fell behind, resync
+                    }
+                } else {
+                    timer->running = false;
+                }
+                taskEXIT_CRITICAL();
+                dispatched++;
+                timer->handler.callback();
+                taskENTER_CRITICAL();
+                if(version != listVersion) {
+                    // Timers were added or removed while unlocked, so timer may be gone.
+                    // Start over, the ones that fired aren't expired now.
+                    version = listVersion;
+                    next = portMAX_DELAY;
+                    timer = timerList;
+                    continue;
+                }
+            }
+        }
+        if(timer->running) {
+            TickType_t remaining = timer->expiry - xTaskGetTickCount();
+            if(remaining > timer->timerPeriod) remaining = 0;
+            if(remaining < next) next = remaining;
+        }
+        timer = timer->link;
+    }
+    taskEXIT_CRITICAL();
+    return next;
+}
+
+void EventLoopBase::attachSources() {
+    taskENTER_CRITICAL();
+    uint32_t version = listVersion;
+    EventSource* source = sourceList;
+    while(source) {
+        if(&source->loop == this) {
+            taskEXIT_CRITICAL();
+            source->attach();
+            taskENTER_CRITICAL();
+            if(version != listVersion) {
+                // Changed while unlocked, attaching again is harmless so start over.
+                version = listVersion;
+                source = sourceList;
+                continue;
+            }
+        }
+        source = source->link;
+    }
+    taskEXIT_CRITICAL();
+}
+
+uint32_t EventLoopBase::runSources(uint32_t work) {
+    uint32_t again = 0;
+    taskENTER_CRITICAL();
+    uint32_t version = listVersion;
+    for(EventSource* source = sourceList; source; source = source->link) {
+        if(&source->loop != this || !(work & source->sourceBit)) continue;
+        taskEXIT_CRITICAL();
+        if(source->ready()) {
+            dispatched++;
+            source->dispatch();
+            // Level triggered, if still ready come back after the others have had a turn.
+            if(source->ready()) again |= source->sourceBit;
+        }
+        taskENTER_CRITICAL();
+        if(version != listVersion) {
+            // Sources were added or removed while unlocked, so source may be gone.
+            // Check all of this pass again next time around.
+            again |= work;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return again;
+}
+
+void EventLoopBase::run() {
+    attachSources();
+    // Notifications sent before we started were cleared by the startup take, so check everything.
+    uint32_t pending = 0xFFFFFFFF;
+    while(1) {
+        TickType_t wait = runTimers();
+        if(pending) wait = 0;
+        uint32_t bits = 0;
+        if(xTaskNotifyWait(0, 0xFFFFFFFF, &bits, wait)) {
+            pending |= bits;
+        }
+        pending = runSources(pending);
+    }
+}
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
@@ -0,0 +1,438 @@
+/**
+ * @file EventLoop.h
+ * @brief Reactor style Event Loop Task
+ *
+ * An EventLoop is a single task that waits for any of a set of event sources (Queues,
+ * StreamBuffers, MessageBuffers, EventGroup bits and LoopTimers) to become ready, and then
+ * calls the handler registered for that source. Handlers run to completion one at a
+ * time on the loop's stack, so many I/O flows can share a single task.
+ *
+ * The loop blocks on its task notification value, with each source being assigned a bit.
+ * The kernel objects don't know about the loop, so whatever puts data into the object
+ * needs to then call the source's notify() (or notify_ISR()) to wake the loop.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_EVENTLOOP_H_
+#define FREERTOSPP_EVENTLOOP_H_
+
+#include "FreeRTOScpp.h"
+#include "CallBack.h"
+#include "EventCPP.h"
+#include "MessageBufferCPP.h"
+#include "QueueCPP.h"
+#include "StreamBufferCPP.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+class EventLoopBase;
+
+/**
+ * @brief Base for the sources of events for an EventLoop.
+ *
+ * Sources are registered with the loop on construction, and are checked in the order
+ * registered. Readiness is level triggered, if a source is still ready after its handler
+ * returns, the loop will come back to it after giving the other ready sources a turn.
+ *
+ * Sources and loops may be constructed in any order, including as globals in different
+ * translation units.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class EventSource {
+    friend class EventLoopBase;
+public:
+    EventSource(EventLoopBase& loop_);
+    virtual ~EventSource();
+
+    /**
+     * @brief Tell the loop that this source may be ready.
+     *
+     * Sources for Queues, StreamBuffers and MessageBuffers do this themselves when data
+     * arrives. Before the scheduler starts this does nothing, as the loop checks all of
+     * its sources when it starts.
+     */
+    void notify();
+    /**
+     * @brief Tell the loop that this source may be ready, from an ISR.
+     * @param waswoken Flag to indicate if a task was woken that needs a yield.
+     */
+    void notify_ISR(portBASE_TYPE& waswoken);
+
+    /**
+     * @brief Get the notification bit assigned to this source.
+     */
+    uint32_t bit() const { return sourceBit; }
+
+protected:
+    /**
+     * @brief Hook the source up to its object, so it is told when data arrives.
+     *
+     * Called by the loop when it starts, when everything has been constructed, or by the
+     * derived constructor if the scheduler is already running. Must be safe to repeat.
+     */
+    virtual void attach() {}
+    /// Does the source have something for the handler.
+    virtual bool ready() = 0;
+    /// Call the handler for one unit of work.
+    virtual void dispatch() = 0;
+
+    EventLoopBase&  loop;
+
+private:
+    uint32_t        sourceBit;
+    EventSource*    link;
+
+#if __cplusplus < 201101L
+    EventSource(EventSource const&);      ///< We are not copyable.
+    void operator =(EventSource const&);  ///< We are not assignable.
+#else
+    EventSource(EventSource const&) = delete;      ///< We are not copyable.
+    void operator =(EventSource const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Watermark that notifies an EventSource when its object stops being empty.
+ *
+ * Used by the sources for Queues, StreamBuffers and MessageBuffers, so sending to the
+ * object raises the notification, from tasks or ISRs.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class SourceWatermark : public Watermark {
+public:
+    SourceWatermark(EventSource& source_) : Watermark(1, 0, nullptr), source(source_) {}
+
+protected:
+    void changed(bool toHigh) override { if(toHigh) source.notify(); }
+    void changed_ISR(bool toHigh, portBASE_TYPE& waswoken) override { if(toHigh) source.notify_ISR(waswoken); }
+
+private:
+    EventSource&    source;
+};
+
+/**
+ * @brief Event Source for a Queue.
+ *
+ * Each dispatch pops one item from the Queue and passes it to the handler.
+ *
+ * The source attaches a Watermark to the Queue to be told when items arrive, so the
+ * Queue can't have another Watermark while the source exists.
+ *
+ * @tparam T The type of item in the Queue.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T>
+class QueueSource : public EventSource {
+public:
+    QueueSource(EventLoopBase& loop_, QueueTypeBase<T>& queue_, CallBack<void, T const&>& handler_) :
+        EventSource(loop_), queue(queue_), handler(handler_), arrival(*this)
+    {
+        if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) attach();
+    }
+    ~QueueSource() { queue.setWatermark(nullptr); }
+
+protected:
+    void attach() override { queue.setWatermark(&arrival); }
+    bool ready() override { return queue.waiting() > 0; }
+    void dispatch() override {
+        T item;
+        if(queue.pop(item, 0)) handler.callback(item);
+    }
+
+private:
+    QueueTypeBase<T>&           queue;
+    CallBack<void, T const&>&   handler;
+    SourceWatermark             arrival;
+};
+
+/**
+ * @brief Event Source for a StreamBuffer.
+ *
+ * The handler is called while the StreamBuffer has data, and reads what it wants.
+ *
+ * Like QueueSource, attaches a Watermark to the StreamBuffer to be told when data arrives.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class StreamSource : public EventSource {
+public:
+    StreamSource(EventLoopBase& loop_, StreamBufferBase& stream_, CallBack<void, StreamBufferBase&>& handler_) :
+        EventSource(loop_), stream(stream_), handler(handler_), arrival(*this)
+    {
+        if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) attach();
+    }
+    ~StreamSource() { stream.setWatermark(nullptr); }
+
+protected:
+    void attach() override { stream.setWatermark(&arrival); }
+    bool ready() override { return !stream.isEmpty(); }
+    void dispatch() override { handler.callback(stream); }
+
+private:
+    StreamBufferBase&                   stream;
+    CallBack<void, StreamBufferBase&>&  handler;
+    SourceWatermark                     arrival;
+};
+
+/**
+ * @brief Event Source for a MessageBuffer.
+ *
+ * The handler is called while the MessageBuffer has a message, and should read it.
+ *
+ * Like QueueSource, attaches a Watermark to the MessageBuffer to be told when messages arrive.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class MessageSource : public EventSource {
+public:
+    MessageSource(EventLoopBase& loop_, MessageBufferBase& buffer_, CallBack<void, MessageBufferBase&>& handler_) :
+        EventSource(loop_), buffer(buffer_), handler(handler_), arrival(*this)
+    {
+        if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) attach();
+    }
+    ~MessageSource() { buffer.setWatermark(nullptr); }
+
+protected:
+    void attach() override { buffer.setWatermark(&arrival); }
+    bool ready() override { return !buffer.isEmpty(); }
+    void dispatch() override { handler.callback(buffer); }
+
+private:
+    MessageBufferBase&                  buffer;
+    CallBack<void, MessageBufferBase&>& handler;
+    SourceWatermark                     arrival;
+};
+
+/**
+ * @brief Event Source for bits in an EventGroup.
+ *
+ * When any of the bits are set, they are cleared and passed to the handler.
+ *
+ * EventGroups have no hook to tell the source when bits are set, so the setter needs to
+ * call notify() after setting them.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class EventBitsSource : public EventSource {
+public:
+    EventBitsSource(EventLoopBase& loop_, EventGroup& group_, EventBits_t bits_, CallBack<void, EventBits_t>& handler_) :
+        EventSource(loop_), group(group_), bits(bits_), handler(handler_) {}
+
+protected:
+    bool ready() override { return (group.get() & bits) != 0; }
+    void dispatch() override {
+        EventBits_t set = group.clear(bits) & bits;
+        if(set) handler.callback(set);
+    }
+
+private:
+    EventGroup&                     group;
+    EventBits_t                     bits;
+    CallBack<void, EventBits_t>&    handler;
+};
+
+/**
+ * @brief Timer run by an EventLoop.
+ *
+ * Unlike a Timer, the handler is run in the EventLoop task, in line with the other
+ * handlers, so doesn't need any locking against them.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class LoopTimer {
+    friend class EventLoopBase;
+public:
+    /**
+     * @brief Constructor
+     * @param loop_ The EventLoop to run the timer on.
+     * @param handler_ The handler to call when the timer expires.
+     * @param period_ The period of the timer.
+     * @param reload_ If true the timer restarts on expiry, otherwise it is one shot.
+     */
+    LoopTimer(EventLoopBase& loop_, CallBack<void>& handler_, TickType_t period_, bool reload_ = false);
+    virtual ~LoopTimer();
+
+    /**
+     * @brief Start (or restart) the timer to expire in period ticks.
+     */
+    void start();
+    /**
+     * @brief Start (or restart) the timer with a new period.
+     */
+    void start(TickType_t period_);
+#if FREERTOSCPP_USE_CHRONO
+    void start(Time_ms period_) { start(ms2ticks(period_)); }
+#endif
+    /**
+     * @brief Stop the timer.
+     */
+    void stop();
+
+    bool        active() const { return running; }
+    TickType_t  period() const { return timerPeriod; }
+    TickType_t  expiryTime() const { return expiry; }
+
+private:
+    EventLoopBase&  loop;
+    CallBack<void>& handler;
+    TickType_t      timerPeriod;
+    TickType_t      expiry;
+    bool            reload;
+    bool            running;
+    LoopTimer*      link;
+
+#if __cplusplus < 201101L
+    LoopTimer(LoopTimer const&);      ///< We are not copyable.
+    void operator =(LoopTimer const&);  ///< We are not assignable.
+#else
+    LoopTimer(LoopTimer const&) = delete;      ///< We are not copyable.
+    void operator =(LoopTimer const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Event Loop.
+ *
+ * Does the work of the loop, the derived class provides the task.
+ *
+ * Up to 31 sources can be registered with a loop, the top notification bit is used
+ * to tell the loop that the timers have changed.
+ *
+ * The sources and timers of all loops are kept in static lists, rather than in the loop,
+ * so a source or timer constructed before its loop (static initialization order) isn't lost.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class EventLoopBase {
+    friend class EventSource;
+    friend class LoopTimer;
+public:
+    EventLoopBase() : dispatched(0) {}
+    virtual ~EventLoopBase() {}
+
+    /**
+     * @brief Number of handler calls made.
+     */
+    uint32_t dispatchCount() const { return dispatched; }
+
+    static constexpr uint32_t TimerBit = 0x8000'0000;   ///< Notification bit for timer changes
+
+protected:
+    /**
+     * @brief Run the loop, must be called by the loop's task.
+     */
+    void run();
+
+    /// Send notification bits to the loop task.
+    virtual void post(uint32_t bits) = 0;
+    /// Send notification bits to the loop task, from an ISR.
+    virtual void post_ISR(uint32_t bits, portBASE_TYPE& waswoken) = 0;
+
+private:
+    /// Run the expired timers, and return how long until the next one.
+    TickType_t runTimers();
+    /// Attach all our sources to their objects.
+    void attachSources();
+    /// Dispatch the ready sources in work, and return those to come back to.
+    uint32_t runSources(uint32_t work);
+
+    uint32_t        dispatched;
+
+#if __cplusplus < 201101L
+    EventLoopBase(EventLoopBase const&);      ///< We are not copyable.
+    void operator =(EventLoopBase const&);  ///< We are not assignable.
+#else
+    EventLoopBase(EventLoopBase const&) = delete;      ///< We are not copyable.
+    void operator =(EventLoopBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Event Loop Task.
+ *
+ * Example Usage:
+ * @code
+ * EventLoop<512> ioLoop("IO", TaskPrio_Mid);
+ *
+ * Queue<Command, 8> commands;
+ * void doCommand(Command const& cmd);
+ * FunctionCallback<void, Command const&> commandHandler(&doCommand);
+ * QueueSource<Command> commandSource(ioLoop, commands, commandHandler);
+ *
+ * void blink();
+ * FunctionCallback<void> blinkHandler(&blink);
+ * LoopTimer blinkTimer(ioLoop, blinkHandler, pdMS_TO_TICKS(500), true);
+ *
+ * blinkTimer.start();
+ *
+ * // In some other task, wakes the loop to run doCommand()
+ * commands.add(cmd);
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task, needs to be enough for all the handlers.
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth>
+class EventLoop : public TaskClassS<stackDepth>, public EventLoopBase {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    EventLoop(char const* name, TaskPriority priority_, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    void task() override { run(); }
+
+protected:
+    void post(uint32_t bits) override { this->notify(bits, eSetBits); }
+    void post_ISR(uint32_t bits, portBASE_TYPE& waswoken) override { this->notify_ISR(bits, eSetBits, waswoken); }
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_EVENTLOOP_H_ */
@@ -50,15 +50,32 @@
  * If non-zero, put FreeRTOScpp library into namespace FreeRTOScpp.
  * If 2, adds a using namespace FreeRTOScpp, so code doesn't need to use that namespace unless conflicts arise.
  * @ingroup FreeRTOSCpp
+ *
+ * @def FREERTOSCPP_USE_PERF_COUNTERS
+ * If non-zero, the wrapper classes count their failed operations (timeouts, full queues, failed creates)
+ * in the built in PerfCounters, see PerfCounters.h
+ * @ingroup FreeRTOSCpp
  */
 
 #if DOXYGEN
 #define FREERTOSCPP_USE_CHRONO 1
 #define FREERTOS_USE_NAMESPACE 2
+#define FREERTOSCPP_USE_PERF_COUNTERS 1
 #endif
 
 #define FREERTOS_VERSION_ALL    (tskKERNEL_VERSION_MAJOR * 1'000'000 + tskKERNEL_VERSION_MINOR * 1000 + tskKERNEL_VERSION_BUILD)
 
+/**
+ * @def FREERTOSCPP_CORES
+ * Number of cores the kernel is scheduling. Kernels that predate SMP support are treated as having one core.
+ * @ingroup FreeRTOSCpp
+ */
+#ifdef configNUMBER_OF_CORES
+#define FREERTOSCPP_CORES   configNUMBER_OF_CORES
+#else
+#define FREERTOSCPP_CORES   1
+#endif
+
 #ifndef FREERTOSCPP_USE_CHRONO
 #define FREERTOSCPP_USE_CHRONO 1        // Define to 1 to add C++ chrono time versions
 #endif
@@ -67,10 +84,44 @@
 #define FREERTOSCPP_USE_NAMESPACE 2		// 0 = No Namespace, 1 = In namespace FreeRTOScpp, 2 = In namespace FreeRTOScpp and then use the namespace
 #endif
 
+#ifndef FREERTOSCPP_USE_PERF_COUNTERS
+#define FREERTOSCPP_USE_PERF_COUNTERS 0     // Define to 1 to count failed operations in the wrappers
+#endif
+
+/**
+ * @def FREERTOSCPP_NOTIFY_INDEX
+ * Task notification index used by wrappers that block on a notification internally (like
+ * SelectiveQueue), kept away from index 0 which TaskBase give()/take() use, so those
+ * wrappers need configTASK_NOTIFICATION_ARRAY_ENTRIES of at least 2. Kernels before 10.4
+ * only have index 0.
+ * @ingroup FreeRTOSCpp
+ */
+#ifndef FREERTOSCPP_NOTIFY_INDEX
+#if FREERTOS_VERSION_ALL >= 10'004'000
+#define FREERTOSCPP_NOTIFY_INDEX    (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#else
+#define FREERTOSCPP_NOTIFY_INDEX    0
+#endif
+#endif
+
 #if FREERTOSCPP_USE_CHRONO
 #include <chrono>
 #endif
 
+/**
+ * @def FREERTOSCPP_PERF_CHECK
+ * Wrap an operation, and if it returns a false/zero result count it in the given built in PerfCounter.
+ * Evaluates to the result of the operation.
+ *
+ * If FREERTOSCPP_USE_PERF_COUNTERS is 0, this is just the operation.
+ * @ingroup FreeRTOSCpp
+ */
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#define FREERTOSCPP_PERF_CHECK(expr, counter)   perfCheck((expr), counter)
+#else
+#define FREERTOSCPP_PERF_CHECK(expr, counter)   (expr)
+#endif
+
 namespace FreeRTOScpp {
 
 #if FREERTOSCPP_USE_CHRONO
@@ -83,9 +134,111 @@ inline constexpr TickType_t ms2ticks(Time_ms ms) {
 }
 #endif
 
+/**
+ * @brief Compare two tick counts, allowing for the tick counter wrapping.
+ * @return true if a is before b.
+ *
+ * Valid as long as the two times are within half the range of TickType_t of each other.
+ * @ingroup FreeRTOSCpp
+ */
+inline constexpr bool tickBefore(TickType_t a, TickType_t b) {
+    return static_cast<TickType_t>(a - b) > (portMAX_DELAY >> 1);
+}
+
+#if INCLUDE_uxTaskPriorityGet
+/**
+ * @brief Get the base priority of a task, without any priority inherited from a mutex it holds.
+ * @param task The task, or nullptr for the calling task.
+ *
+ * Used when saving a priority to restore later, as restoring an inherited priority would
+ * make the boost permanent. Kernels before 11.0 without configUSE_TRACE_FACILITY can only
+ * give the current priority.
+ * @ingroup FreeRTOSCpp
+ */
+inline UBaseType_t basePriority(TaskHandle_t task) {
+#if FREERTOS_VERSION_ALL >= 11'000'000 && configUSE_MUTEXES
+    return uxTaskBasePriorityGet(task);
+#elif configUSE_TRACE_FACILITY && configUSE_MUTEXES
+    TaskStatus_t status;
+    vTaskGetInfo(task, &status, pdFALSE, eInvalid);
+    return status.uxBasePriority;
+#else
+    return uxTaskPriorityGet(task);
+#endif
+}
+#endif
+
+/**
+ * @brief Get the core we are running on.
+ * @return The index of the current core, always 0 on single core builds.
+ *
+ * Note, unless preemption is blocked, a task may migrate right after this returns,
+ * so the value is only a hint, good for picking a per-core shard.
+ */
+inline unsigned currentCore() {
+#if FREERTOSCPP_CORES > 1
+    return portGET_CORE_ID();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief ISR Yield Scope.
+ *
+ * Collects the "woken" flags from any number of _ISR calls in an interrupt, and does the
+ * one portYIELD_FROM_ISR() needed when it goes out of scope, so it can't be forgotten.
+ *
+ * It converts to the portBASE_TYPE& that every _ISR method takes as its waswoken
+ * parameter, so can be passed directly to any of them.
+ *
+ * Example Usage:
+ * @code
+ * extern "C" void UART_IRQHandler() {
+ *     IsrScope isr;
+ *     rxQueue.add_ISR(UART->DATA, isr);
+ *     rxEvents.set_ISR(RxBit, isr);
+ *     rxTask.give_ISR(isr);
+ * }   // Yields here if any of the above woke a higher priority task.
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class IsrScope {
+public:
+    IsrScope() : woken(pdFALSE) {}
+    ~IsrScope() { portYIELD_FROM_ISR(woken); }
+
+    /// Pass as the waswoken parameter of an _ISR function.
+    operator portBASE_TYPE&() { return woken; }
+    /// Pointer for the raw FreeRTOS FromISR API functions.
+    portBASE_TYPE* ptr() { return &woken; }
+    /// Has a higher priority task been woken (so we will yield).
+    bool wasWoken() const { return woken != pdFALSE; }
+
+private:
+    portBASE_TYPE woken;
+
+#if __cplusplus < 201101L
+    IsrScope(IsrScope const&);      ///< We are not copyable.
+    void operator =(IsrScope const&);  ///< We are not assignable.
+#else
+    IsrScope(IsrScope const&) = delete;      ///< We are not copyable.
+    void operator =(IsrScope const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
 }   // namespace FreeRTOScpp
 #if FREERTOSCPP_USE_NAMESPACE == 2
 using namespace FreeRTOScpp;
+#elif FREERTOSCPP_USE_NAMESPACE == 0
+// The helpers above are always in the namespace, bring them out for the wrappers.
+using FreeRTOScpp::currentCore;
+using FreeRTOScpp::tickBefore;
+using FreeRTOScpp::IsrScope;
+#if INCLUDE_uxTaskPriorityGet
+using FreeRTOScpp::basePriority;
+#endif
 #endif
 
 #endif /* FREERTOSPP_FREERTOSCPP_H_ */
@@ -0,0 +1,109 @@
+/**
+ * @file IdleExecutor.cpp
+ * @brief Idle Time Background Work Executor
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "IdleExecutor.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+IdleWork::IdleWork(IdleExecutor& executor_, bool start_) :
+executor(executor_),
+link(nullptr),
+active(start_),
+restarted(false)
+{
+    taskENTER_CRITICAL();
+    link = executor.items;
+    executor.items = this;
+    taskEXIT_CRITICAL();
+}
+
+IdleWork::~IdleWork() {
+    taskENTER_CRITICAL();
+    IdleWork** ptr = &executor.items;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    if(executor.cursor == this) executor.cursor = link;
+    taskEXIT_CRITICAL();
+}
+
+void IdleWork::start() {
+    restarted = true;
+    active = true;
+    executor.wake();
+}
+
+bool IdleExecutor::hasWork() const {
+    for(IdleWork* item = items; item; item = item->link) {
+        if(item->active) return true;
+    }
+    return false;
+}
+
+bool IdleExecutor::runSlice() {
+    TickType_t start = xTaskGetTickCount();
+    unsigned count = 0;
+    unsigned idle = 0;      // Items in a row found inactive, to stop when there is no work
+    unsigned total = 0;
+    for(IdleWork* item = items; item; item = item->link) total++;
+
+    while(idle < total) {
+        if(cursor == nullptr) cursor = items;
+        IdleWork* item = cursor;
+        cursor = item->link;
+        if(!item->active) {
+            idle++;
+            continue;
+        }
+        idle = 0;
+        item->restarted = false;
+        if(!item->step() && !item->restarted) item->active = false;
+        count++;
+        if(maxSteps && count >= maxSteps) break;
+        if(maxTicks && static_cast<TickType_t>(xTaskGetTickCount() - start) >= maxTicks) break;
+    }
+    steps += count;
+    if(count) slices++;
+    return count > 0;
+}
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file IdleExecutor.h
+ * @brief Idle Time Background Work Executor
+ *
+ * Runs low value background work (flash wear leveling, statistics compaction,
+ * memory scrubbing, ...) only when the CPU would otherwise be idle, in short slices
+ * so a higher priority task that becomes ready is only delayed by a bounded amount.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_IDLEEXECUTOR_H_
+#define FREERTOSPP_IDLEEXECUTOR_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+class IdleExecutor;
+
+/**
+ * @brief Background Work Item.
+ *
+ * Derive from this and define step() to do one short, bounded piece of the work.
+ * The item is run once start() has been called, until step() returns false.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class IdleWork {
+    friend class IdleExecutor;
+public:
+    /**
+     * @brief Constructor
+     * @param executor_ The executor to run the work on.
+     * @param start_ If true, the work is active from the start.
+     */
+    IdleWork(IdleExecutor& executor_, bool start_ = false);
+    virtual ~IdleWork();
+
+    /**
+     * @brief Make the work active, so step() will be called.
+     *
+     * May be called from within step() to keep the work active.
+     */
+    void start();
+    /**
+     * @brief Make the work inactive.
+     */
+    void stop() { active = false; }
+    /**
+     * @brief Is the work active.
+     */
+    bool isActive() const { return active; }
+
+protected:
+    /**
+     * @brief Do one step of the work.
+     *
+     * Each step should be short, as a higher priority task may need to wait for it
+     * to finish (the executor only checks its budget between steps).
+     *
+     * @return true if there is more to do, false to go inactive.
+     */
+    virtual bool step() = 0;
+
+private:
+    IdleExecutor&   executor;
+    IdleWork*       link;
+    volatile bool   active;
+    volatile bool   restarted;      ///< start() was called while running a step
+
+#if __cplusplus < 201101L
+    IdleWork(IdleWork const&);      ///< We are not copyable.
+    void operator =(IdleWork const&);  ///< We are not assignable.
+#else
+    IdleWork(IdleWork const&) = delete;      ///< We are not copyable.
+    void operator =(IdleWork const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Idle Time Work Executor.
+ *
+ * Runs the active IdleWork items round robin, one step at a time, in slices. A slice ends
+ * after maxSteps steps, or once maxTicks ticks have passed, whichever is first, so the
+ * time a slice runs is bounded by the budget plus one step.
+ *
+ * Can be run from the idle hook:
+ * @code
+ * IdleExecutor idleWork(4, 1);
+ *
+ * extern "C" void vApplicationIdleHook() {
+ *     idleWork.runSlice();
+ * }
+ * @endcode
+ * or see IdleExecutorTask.
+ *
+ * When run from the idle hook, steps must not block.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class IdleExecutor {
+    friend class IdleWork;
+public:
+    /**
+     * @brief Constructor
+     * @param maxSteps_ The maximum number of steps in a slice, 0 for no limit.
+     * @param maxTicks_ The maximum ticks for a slice, 0 for no limit.
+     * At least one must be limited, or a slice would never end.
+     */
+    IdleExecutor(unsigned maxSteps_ = 1, TickType_t maxTicks_ = 0) :
+        maxSteps(maxSteps_), maxTicks(maxTicks_), items(nullptr), cursor(nullptr), steps(0), slices(0)
+    {
+        configASSERT(maxSteps || maxTicks);
+    }
+    virtual ~IdleExecutor() {}
+
+    /**
+     * @brief Run one slice of work.
+     * @return true if any work was done.
+     */
+    bool runSlice();
+
+    /**
+     * @brief Is any work active.
+     */
+    bool hasWork() const;
+
+    /**
+     * @brief Change the slice budget, at least one must be limited.
+     */
+    void budget(unsigned maxSteps_, TickType_t maxTicks_) {
+        configASSERT(maxSteps_ || maxTicks_);
+        maxSteps = maxSteps_;
+        maxTicks = maxTicks_;
+    }
+
+    /**
+     * @brief Number of steps run.
+     */
+    uint32_t stepCount() const { return steps; }
+    /**
+     * @brief Number of slices that did some work.
+     */
+    uint32_t sliceCount() const { return slices; }
+
+protected:
+    /// Called when work is started, so a task running us can wake up.
+    virtual void wake() {}
+
+private:
+    unsigned    maxSteps;
+    TickType_t  maxTicks;
+    IdleWork*   items;
+    IdleWork*   cursor;         ///< Next item to run, for round robin
+    uint32_t    steps;
+    uint32_t    slices;
+
+#if __cplusplus < 201101L
+    IdleExecutor(IdleExecutor const&);      ///< We are not copyable.
+    void operator =(IdleExecutor const&);  ///< We are not assignable.
+#else
+    IdleExecutor(IdleExecutor const&) = delete;      ///< We are not copyable.
+    void operator =(IdleExecutor const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Idle Time Work Executor Task.
+ *
+ * Runs the IdleExecutor in its own task, normally just above idle priority, which allows
+ * steps to use more stack than the idle task has, and to block. The task yields between
+ * slices, and sleeps while there is no active work.
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth>
+class IdleExecutorTask : public TaskClassS<stackDepth>, public IdleExecutor {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param maxSteps_ The maximum number of steps in a slice, 0 for no limit.
+     * @param maxTicks_ The maximum ticks for a slice, 0 for no limit.
+     * @param priority_ The priority of the task.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    IdleExecutorTask(char const* name, unsigned maxSteps_ = 1, TickType_t maxTicks_ = 0,
+                     TaskPriority priority_ = TaskPrio_Idle + 1, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_),
+        IdleExecutor(maxSteps_, maxTicks_)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    void task() override {
+        while(1) {
+            if(runSlice()) {
+                taskYIELD();
+            } else {
+                TaskBase::take();
+            }
+        }
+    }
+
+protected:
+    void wake() override { this->give(); }
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_IDLEEXECUTOR_H_ */
@@ -0,0 +1,385 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Fixed memory Latency Histogram
+ *
+ * This file provides a histogram for recording latency distributions (ISR to task time,
+ * queue residency, lock hold time, ...) on the device, without needing to ship out the
+ * raw samples.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_LATENCYHISTOGRAM_H_
+#define FREERTOSPP_LATENCYHISTOGRAM_H_
+
+#include "FreeRTOScpp.h"
+#include "Atomic.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Common query operations for the Latency Histograms
+ *
+ * Provides the bucket layout, and the queries that are built on top of reading the buckets.
+ * The Derived class needs to provide uint32_t bucket(unsigned idx) const.
+ *
+ * @tparam Derived      The histogram class (CRTP)
+ * @tparam subBits      Number of bits of resolution kept within each power of two.
+ * @tparam valueBits    Number of significant bits in the largest recordable value. Larger values go into the last bucket.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+template<class Derived, unsigned subBits, unsigned valueBits>
+class HistogramBase {
+    static_assert(subBits > 0 && subBits < valueBits, "subBits must be between 1 and valueBits-1");
+    static_assert(valueBits <= 32, "Values are limited to 32 bits");
+public:
+    static constexpr unsigned subBuckets = 1u << subBits;                   ///< Sub-Buckets per power of two
+    static constexpr unsigned numBuckets = (valueBits - subBits + 1) * subBuckets; ///< Total Number of buckets
+
+    /**
+     * @brief Get the number of values recorded.
+     */
+    uint32_t count() const {
+        uint32_t total = 0;
+        for(unsigned i = 0; i < numBuckets; i++) {
+            total += self().bucket(i);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Find the value at a given percentile.
+     *
+     * The value returned is the highest value that would be recorded in the same bucket as the
+     * percentile, so is a conservative (high) estimate.
+     *
+     * @param part The part of whole to find, percentile(99) is the 99th percentile, percentile(999, 1000) is the 99.9th
+     * @param whole The scale of part.
+     * @return The value at that percentile, 0 if nothing has been recorded.
+     */
+    uint32_t percentile(uint32_t part, uint32_t whole = 100) const {
+        configASSERT(whole > 0 && part <= whole);
+        uint32_t total = count();
+        if(total == 0) return 0;
+        // Round up, so percentile(100) is the max, and percentile(0) is the min
+        uint64_t target = (static_cast<uint64_t>(total) * part + whole - 1) / whole;
+        if(target == 0) target = 1;
+        uint64_t seen = 0;
+        for(unsigned i = 0; i < numBuckets; i++) {
+            seen += self().bucket(i);
+            if(seen >= target) return highestValue(i);
+        }
+        return highestValue(numBuckets-1);
+    }
+
+    /**
+     * @brief Lowest recorded value (to bucket resolution)
+     * @return The lowest value of the lowest non-empty bucket, 0 if empty.
+     */
+    uint32_t min() const {
+        for(unsigned i = 0; i < numBuckets; i++) {
+            if(self().bucket(i)) return lowestValue(i);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Highest recorded value (to bucket resolution)
+     * @return The highest value of the highest non-empty bucket, 0 if empty.
+     */
+    uint32_t max() const {
+        for(unsigned i = numBuckets; i > 0; i--) {
+            if(self().bucket(i-1)) return highestValue(i-1);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Export the histogram in a compact binary form.
+     *
+     * Format:
+     * + 1 byte: subBits
+     * + 1 byte: valueBits
+     * + For each non-empty bucket, in increasing order:
+     *   + LEB128 varint: bucket index minus the previous non-empty bucket index (first is the index + 1)
+     *   + LEB128 varint: count
+     *
+     * The end of the data is given by the length returned.
+     *
+     * @param buf Buffer to fill, if nullptr, just compute the size needed.
+     * @param len Size of the buffer
+     * @return The number of bytes used, or 0 if the buffer was too small.
+     */
+    size_t serialize(uint8_t* buf, size_t len) const {
+        if(buf == nullptr) len = maxSerializedSize();
+        if(len < 2) return 0;
+        size_t pos = 0;
+        putByte(buf, pos, subBits);
+        putByte(buf, pos, valueBits);
+        unsigned last = 0;
+        for(unsigned i = 0; i < numBuckets; i++) {
+            uint32_t cnt = self().bucket(i);
+            if(cnt == 0) continue;
+            if(!putVarint(buf, len, pos, i + 1 - last)) return 0;
+            if(!putVarint(buf, len, pos, cnt)) return 0;
+            last = i + 1;
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Maximum size that serialize() might need.
+     */
+    static constexpr size_t maxSerializedSize() { return 2 + numBuckets * (2 + 5); }
+
+    /**
+     * @brief Get the bucket a value will be recorded in.
+     */
+    static unsigned index(uint32_t value) {
+        if(value < subBuckets) return value;
+        unsigned e = log2(value);
+        if(e >= valueBits) return numBuckets-1;
+        return ((e - subBits + 1) << subBits) + ((value >> (e - subBits)) - subBuckets);
+    }
+
+    /**
+     * @brief Get the lowest value that is recorded in a bucket.
+     */
+    static uint32_t lowestValue(unsigned idx) {
+        if(idx < subBuckets) return idx;
+        unsigned e = (idx >> subBits) + subBits - 1;
+        return static_cast<uint32_t>(subBuckets + (idx & (subBuckets-1))) << (e - subBits);
+    }
+
+    /**
+     * @brief Get the highest value that is recorded in a bucket.
+     */
+    static uint32_t highestValue(unsigned idx) {
+        if(idx < subBuckets) return idx;
+        unsigned e = (idx >> subBits) + subBits - 1;
+        return lowestValue(idx) + ((static_cast<uint32_t>(1) << (e - subBits)) - 1);
+    }
+
+private:
+    Derived const& self() const { return *static_cast<Derived const*>(this); }
+
+    static unsigned log2(uint32_t value) {
+#if defined(__GNUC__)
+        return 31 - __builtin_clz(value);
+#else
+        unsigned e = 0;
+        while(value >>= 1) e++;
+        return e;
+#endif
+    }
+
+    static void putByte(uint8_t* buf, size_t& pos, uint8_t byte) {
+        if(buf) buf[pos] = byte;
+        pos++;
+    }
+
+    static bool putVarint(uint8_t* buf, size_t len, size_t& pos, uint32_t value) {
+        do {
+            if(pos >= len) return false;
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            putByte(buf, pos, value ? (byte | 0x80) : byte);
+        } while(value);
+        return true;
+    }
+};
+
+/**
+ * @brief Log-Linear (HDR style) Latency Histogram
+ *
+ * Values below 2^subBits each get their own bucket. Above that, each power of two range
+ * [2^e, 2^(e+1)) is split into 2^subBits equal sub-buckets, so every bucket has a relative
+ * width of at most 1/2^subBits of its value (12.5% for the default of 3).
+ *
+ * The memory used is fixed at (valueBits - subBits + 1) * 2^subBits counters, 240 words for
+ * the defaults.
+ *
+ * Recording a value is a single relaxed atomic increment, so record() can be used from both
+ * tasks and ISRs, with no critical section on cores with native atomics (see Atomic).
+ * Queries (count, percentile, export) read the counters without stopping the recorders, so
+ * they see a "fuzzy" snapshot if recording is happening at the same time.
+ *
+ * The units of the values are up to the user, typically ticks or a cycle counter.
+ *
+ * Example Usage:
+ * @code
+ * LatencyHistogram<> isrLatency;
+ *
+ * // In the ISR
+ * stamp = DWT->CYCCNT;
+ *
+ * // In the Task
+ * isrLatency.record(DWT->CYCCNT - stamp);
+ *
+ * // Reporting
+ * uint32_t p99 = isrLatency.percentile(99);
+ * @endcode
+ *
+ * @tparam subBits      Number of bits of resolution kept within each power of two.
+ * @tparam valueBits    Number of significant bits in the largest recordable value. Larger values go into the last bucket.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+template<unsigned subBits = 3, unsigned valueBits = 32>
+class LatencyHistogram : public HistogramBase<LatencyHistogram<subBits, valueBits>, subBits, valueBits> {
+    typedef HistogramBase<LatencyHistogram<subBits, valueBits>, subBits, valueBits> Base;
+public:
+    using Base::numBuckets;
+    using Base::index;
+
+    LatencyHistogram() { reset(); }
+
+    /**
+     * @brief Record a value.
+     *
+     * Safe to call from tasks and ISRs.
+     *
+     * @param value The value to record.
+     * @param count The number of times to record the value.
+     */
+    void record(uint32_t value, uint32_t count = 1) {
+        counts[index(value)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Clear all the recorded values.
+     */
+    void reset() {
+        for(unsigned i = 0; i < numBuckets; i++) {
+            counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add in the counts from another histogram.
+     *
+     * Used to combine shards, or intervals of recording.
+     * @param other The histogram to add in.
+     */
+    void merge(LatencyHistogram const& other) {
+        for(unsigned i = 0; i < numBuckets; i++) {
+            uint32_t cnt = other.bucket(i);
+            if(cnt) counts[i].fetch_add(cnt, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Get the count in a given bucket.
+     * @param idx The bucket index, 0 to numBuckets-1
+     */
+    uint32_t bucket(unsigned idx) const {
+        return idx < numBuckets ? counts[idx].load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    Atomic<uint32_t, Atomic_IsrSafe>    counts[numBuckets];
+};
+
+/**
+ * @brief Per-Core Sharded Latency Histogram
+ *
+ * On SMP systems, many cores recording into the same histogram will fight over the cache lines of the
+ * counters. This version keeps a shard per core, each recorder uses the shard of the core it is running on,
+ * and the shards are summed when the results are needed, so all the queries of LatencyHistogram are available.
+ *
+ * On single core builds this is just a single LatencyHistogram.
+ *
+ * @tparam subBits      Number of bits of resolution kept within each power of two.
+ * @tparam valueBits    Number of significant bits in the largest recordable value.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+template<unsigned subBits = 3, unsigned valueBits = 32>
+class ShardedLatencyHistogram : public HistogramBase<ShardedLatencyHistogram<subBits, valueBits>, subBits, valueBits> {
+    typedef HistogramBase<ShardedLatencyHistogram<subBits, valueBits>, subBits, valueBits> Base;
+public:
+    typedef LatencyHistogram<subBits, valueBits> Histogram;
+    using Base::numBuckets;
+
+    /**
+     * @brief Record a value in the shard for the current core.
+     *
+     * Safe to call from tasks and ISRs. If a task migrates between finding the core and recording,
+     * it just records into the other cores shard, which is still correct, just slower.
+     */
+    void record(uint32_t value, uint32_t count = 1) {
+        shard[currentCore()].record(value, count);
+    }
+
+    /**
+     * @brief Clear all the shards.
+     */
+    void reset() {
+        for(unsigned i = 0; i < FREERTOSCPP_CORES; i++) shard[i].reset();
+    }
+
+    /**
+     * @brief Merge all the shards into a single histogram.
+     * @param out The histogram to receive the results. It is reset first.
+     */
+    void snapshot(Histogram& out) const {
+        out.reset();
+        for(unsigned i = 0; i < FREERTOSCPP_CORES; i++) out.merge(shard[i]);
+    }
+
+    /**
+     * @brief Get the count in a given bucket, summed over all the cores.
+     * @param idx The bucket index, 0 to numBuckets-1
+     */
+    uint32_t bucket(unsigned idx) const {
+        uint32_t total = 0;
+        for(unsigned i = 0; i < FREERTOSCPP_CORES; i++) total += shard[i].bucket(idx);
+        return total;
+    }
+
+    /**
+     * @brief Get the histogram for a single core.
+     */
+    Histogram const& core(unsigned idx) const { return shard[idx]; }
+
+private:
+    Histogram   shard[FREERTOSCPP_CORES];
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_LATENCYHISTOGRAM_H_ */
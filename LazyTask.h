@@ -0,0 +1,373 @@
+/**
+ * @file LazyTask.h
+ * @brief Tasks Created on First Use
+ *
+ * Task objects that are only needed in rare modes still cost boot time (and heap, for
+ * dynamic tasks) if created at startup. A LazyTask keeps its creation parameters and
+ * creates the FreeRTOS task the first time it is started, given to, or notified.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_LAZYTASK_H_
+#define FREERTOSPP_LAZYTASK_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Base for Tasks Created on First Use.
+ *
+ * Holds the creation parameters, the storage classes LazyTaskS and LazyTaskClassS
+ * provide the creation.
+ *
+ * start(), give(), notify() and their indexed versions create the task if it hasn't been
+ * yet. Creation is done with the scheduler suspended, so if several tasks race to make
+ * the first use, only one creates the task.
+ *
+ * Other TaskBase operations, and the _ISR versions (which can't create the task), act on
+ * the task handle, so need the task to have been started first; the _ISR versions here
+ * just do nothing until then.
+ *
+ * These hide the TaskBase versions rather than override them, so creating on first use only
+ * works when called through the LazyTask type. Through a TaskBase& (a TaskGroup member, an
+ * RpcServer's task) nothing is created and the notify functions assert, so call start()
+ * before handing the task out as a TaskBase. (TaskBase::find() only finds started tasks.)
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class LazyTaskBase : public TaskBase {
+protected:
+    /**
+     * @brief Constructor.
+     *
+     * @param name_ The name of the task.
+     * @param taskfun_ The function implementing the task.
+     * @param priority_ The priority of the task.
+     * @param myParm_ The parameter passed to taskfun.
+     */
+    LazyTaskBase(char const* name_, void (*taskfun_)(void*), TaskPriority priority_, void* myParm_) :
+        TaskBase(),
+        name(name_),
+        taskfun(taskfun_),
+        myParm(myParm_),
+        createPriority(priority_),
+        finished(false)
+    {}
+
+    /// Create the task, filling in taskHandle. Called with the scheduler suspended.
+    virtual void create() = 0;
+    /**
+     * @brief Called by the task when its function has returned, just before it deletes itself.
+     *
+     * Forgets the handle, so nothing is sent to the deleted task (and the destructor doesn't
+     * delete it again), and marks the task finished, so it isn't created again.
+     */
+    void finish() {
+        vTaskSuspendAll();
+        indexRemove();
+        finished = true;
+        taskHandle = nullptr;
+        xTaskResumeAll();
+    }
+
+    char const* name;
+    void        (*taskfun)(void*);
+    void*       myParm;
+    TaskPriority createPriority;
+    volatile bool finished;     ///< The task has run and ended.
+
+public:
+    /**
+     * @brief Create the task, if not already created.
+     *
+     * A task that has run and ended is not created again.
+     * @return true if the task exists.
+     */
+    bool start() {
+        if(taskHandle) return true;
+        if(finished) return false;
+        vTaskSuspendAll();
+        if(!taskHandle && !finished) {
+            create();
+            indexAdd();
+        }
+        xTaskResumeAll();
+        return taskHandle != nullptr;
+    }
+    /**
+     * @brief Has the task been created, and not yet ended.
+     */
+    bool started() const { return taskHandle != nullptr; }
+    /**
+     * @brief Has the task run and ended (its function returned).
+     */
+    bool ended() const { return finished; }
+
+    /**
+     * @brief Notify the Task, creating it if needed.
+     */
+    bool notify(uint32_t value, eNotifyAction act) {
+        return start() && TaskBase::notify(value, act);
+    }
+    /**
+     * @brief Notify the Task as a semaphore, creating it if needed.
+     */
+    bool give() {
+        return start() && TaskBase::give();
+    }
+    /**
+     * @brief Notify the Task from an ISR.
+     *
+     * The task is not created from an ISR, if it hasn't been started (or has ended) the
+     * notification is dropped.
+     * @return false if the task hasn't been started.
+     */
+    bool notify_ISR(uint32_t value, eNotifyAction act, portBASE_TYPE& waswoken) {
+        return taskHandle && TaskBase::notify_ISR(value, act, waswoken);
+    }
+    /**
+     * @brief Notify the Task as a semaphore from an ISR.
+     *
+     * The task is not created from an ISR, if it hasn't been started (or has ended) the
+     * notification is dropped.
+     */
+    void give_ISR(portBASE_TYPE& waswoken) {
+        if(taskHandle) TaskBase::give_ISR(waswoken);
+    }
+#if FREERTOS_VERSION_ALL >= 10'004'000
+    /**
+     * @brief Notify the Task at an index, creating it if needed.
+     */
+    bool notifyIndex(UBaseType_t idx, uint32_t value, eNotifyAction act) {
+        return start() && TaskBase::notifyIndex(idx, value, act);
+    }
+    /**
+     * @brief Notify the Task as a semaphore at an index, creating it if needed.
+     */
+    bool giveIndex(UBaseType_t idx) {
+        return start() && TaskBase::giveIndex(idx);
+    }
+#endif
+};
+
+/**
+ * @brief Statically Allocated Task Created on First Use.
+ *
+ * The TCB and stack are reserved with the object, so creation can't fail for lack of memory.
+ *
+ * Example Usage:
+ * @code
+ * LazyTaskS<256> calibrate("Calibrate", &calibrateTask, TaskPrio_Low);
+ *
+ * // Only when entering calibration mode
+ * calibrate.give();
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    =0
+#endif
+    > class LazyTaskS : public LazyTaskBase {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param name The name of the task.
+     * @param taskfun The function implementing the task, should have type void (*taskfun)(void *)
+     * @param priority_ The priority of the task. Use the TaskPriority enum values or a related value converted to a TaskPriority
+     * @param myParm the parameter passed to taskFun. Defaults to NULL.
+     *
+     * The task is not created until first use.
+     */
+    LazyTaskS(char const* name, void (*taskfun)(void*), TaskPriority priority_, void* myParm = nullptr) :
+        LazyTaskBase(name, taskfun, priority_, myParm)
+    {}
+
+protected:
+    void create() override {
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        taskHandle = FREERTOSCPP_PERF_CHECK(xTaskCreateStatic(taskfun, name, stackDepth, myParm, createPriority, stack, &tcb), perfTaskCreateFail);
+#else
+        (void) FREERTOSCPP_PERF_CHECK(xTaskCreate(taskfun, name, stackDepth, myParm, createPriority, &taskHandle) == pdPASS, perfTaskCreateFail);
+#endif
+    }
+
+private:
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+    StaticTask_t tcb;
+    StackType_t stack[stackDepth];
+#endif
+};
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+/**
+ * @brief Dynamically Allocated Task Created on First Use.
+ *
+ * The heap is not used until the task is created, so creation, and thus start(), can fail.
+ * @ingroup FreeRTOSCpp
+ */
+template<> class LazyTaskS<0> : public LazyTaskBase {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param name The name of the task.
+     * @param taskfun The function implementing the task, should have type void (*taskfun)(void *)
+     * @param priority_ The priority of the task. Use the TaskPriority enum values or a related value converted to a TaskPriority
+     * @param stackSize_ Size of the stack to give to the task
+     * @param myParm the parameter passed to taskFun. Defaults to NULL.
+     *
+     * The task is not created until first use.
+     */
+    LazyTaskS(char const* name, void (*taskfun)(void*), TaskPriority priority_,
+            unsigned portSHORT stackSize_, void* myParm = nullptr) :
+        LazyTaskBase(name, taskfun, priority_, myParm),
+        stackSize(stackSize_)
+    {}
+
+protected:
+    void create() override {
+        (void) FREERTOSCPP_PERF_CHECK(xTaskCreate(taskfun, name, stackSize, myParm, createPriority, &taskHandle) == pdPASS, perfTaskCreateFail);
+    }
+
+private:
+    unsigned portSHORT stackSize;
+};
+
+typedef LazyTaskS<0> LazyTask;
+#endif
+
+/**
+ * @brief Class based Task Created on First Use.
+ *
+ * Derive from LazyTaskClassS and the 'task()' member function will get called as the task,
+ * once the task is started.
+ *
+ * Unlike TaskClassS, the derived constructor doesn't need to give() the task, as it can't
+ * be created until the object is fully constructed. The first give() is delivered to
+ * task() like any other.
+ *
+ * If task() returns the task will be deleted if deletion has been enabled.
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth> class LazyTaskClassS : public TaskClassBase, public LazyTaskS<stackDepth> {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task. Use the TaskPriority enum values or a related value converted to a TaskPriority
+     */
+    LazyTaskClassS(char const* name, TaskPriority priority_) :
+        LazyTaskS<stackDepth>(name, &lazyTaskThunk, priority_, static_cast<TaskClassBase*>(this))
+    {}
+
+    virtual ~LazyTaskClassS() {}
+
+    /**
+     * @brief task function.
+     * The member function task needs to
+     */
+    void task() override = 0;
+
+protected:
+    void taskEnded() override { this->finish(); }
+
+    /// Task function, the object is already constructed, so no startup handshake is needed.
+    static void lazyTaskThunk(void* parm) {
+        static_cast<TaskClassBase*>(parm)->task();
+#if INCLUDE_vTaskDelete
+        static_cast<LazyTaskClassS*>(static_cast<TaskClassBase*>(parm))->taskEnded();
+        vTaskDelete(nullptr);
+#else
+        while(1) {
+            vTaskDelay(portMAX_DELAY);
+        }
+#endif
+    }
+};
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+template<> class LazyTaskClassS<0> : public TaskClassBase, public LazyTaskS<0> {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task. Use the TaskPriority enum values or a related value converted to a TaskPriority
+     * @param stackDepth_ How many words of stack to allocate to the task.
+     */
+    LazyTaskClassS(char const* name, TaskPriority priority_, unsigned portSHORT stackDepth_) :
+        LazyTaskS<0>(name, &lazyTaskThunk, priority_, stackDepth_, static_cast<TaskClassBase*>(this))
+    {}
+
+    virtual ~LazyTaskClassS() {}
+
+    /**
+     * @brief task function.
+     * The member function task needs to
+     */
+    void task() override = 0;
+
+protected:
+    void taskEnded() override { this->finish(); }
+
+    /// Task function, the object is already constructed, so no startup handshake is needed.
+    static void lazyTaskThunk(void* parm) {
+        static_cast<TaskClassBase*>(parm)->task();
+#if INCLUDE_vTaskDelete
+        static_cast<LazyTaskClassS*>(static_cast<TaskClassBase*>(parm))->taskEnded();
+        vTaskDelete(nullptr);
+#else
+        while(1) {
+            vTaskDelay(portMAX_DELAY);
+        }
+#endif
+    }
+};
+
+typedef LazyTaskClassS<0> LazyTaskClass;
+#endif
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_LAZYTASK_H_ */
@@ -0,0 +1,191 @@
+/**
+ * @file LoadBalancer.cpp
+ * @brief SMP Load Balancing by Task Affinity
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "LoadBalancer.h"
+#include "CpuBudget.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if FREERTOSCPP_CORES > 1 && configUSE_CORE_AFFINITY && configGENERATE_RUN_TIME_STATS
+
+/// The core a mask allows, or -1 if it allows none or more than one.
+static int singleCore(UBaseType_t mask) {
+    int core = -1;
+    for(unsigned i = 0; i < FREERTOSCPP_CORES; ++i) {
+        if(mask & (UBaseType_t(1) << i)) {
+            if(core >= 0) return -1;
+            core = i;
+        }
+    }
+    return core;
+}
+
+LoadBalanced::LoadBalanced(LoadBalancerBase& balancer_, TaskBase& task_) :
+balancer(balancer_),
+managed(task_),
+lastCounter(0),
+recent(0),
+assigned(tskNO_AFFINITY),
+moveCount(0),
+manual(false),
+sampled(false),
+link(nullptr)
+{
+    taskENTER_CRITICAL();
+    link = balancer.tasks;
+    balancer.tasks = this;
+    taskEXIT_CRITICAL();
+}
+
+LoadBalanced::~LoadBalanced() {
+    taskENTER_CRITICAL();
+    LoadBalanced** ptr = &balancer.tasks;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void LoadBalanced::pin(UBaseType_t mask) {
+    configASSERT(managed.getTaskHandle());
+    manual = true;
+    vTaskCoreAffinitySet(managed.getTaskHandle(), mask);
+}
+
+void LoadBalanced::unpin() {
+    configASSERT(managed.getTaskHandle());
+    // Placed afresh on the next balance.
+    assigned = tskNO_AFFINITY;
+    vTaskCoreAffinitySet(managed.getTaskHandle(), tskNO_AFFINITY);
+    manual = false;
+}
+
+void LoadBalancerBase::place(LoadBalanced& task, unsigned core) {
+    task.assigned = UBaseType_t(1) << core;
+    vTaskCoreAffinitySet(task.managed.getTaskHandle(), task.assigned);
+    loads[core] += task.recent;
+}
+
+void LoadBalancerBase::balance() {
+    // The list is changed by the LoadBalanced constructor and destructor, in other tasks.
+    // The kernel calls made are all usable inside a critical section.
+    taskENTER_CRITICAL();
+    rebalance();
+    taskEXIT_CRITICAL();
+}
+
+void LoadBalancerBase::rebalance() {
+    for(unsigned i = 0; i < FREERTOSCPP_CORES; ++i) loads[i] = 0;
+
+    // Sample, and total the load of the tasks already on a single core.
+    for(LoadBalanced* task = tasks; task; task = task->link) {
+        TaskHandle_t handle = task->managed.getTaskHandle();
+        // No task (yet), a null handle would have us sampling and pinning ourselves.
+        if(!handle) continue;
+        if(!task->sampled) {
+            // First sight of the task, take the starting point, and whether it was pinned already.
+            task->sampled = true;
+            task->lastCounter = CpuBudget::runTime(handle);
+            if(vTaskCoreAffinityGet(handle) != tskNO_AFFINITY) task->manual = true;
+            continue;
+        }
+        configRUN_TIME_COUNTER_TYPE counter = CpuBudget::runTime(handle);
+        configRUN_TIME_COUNTER_TYPE delta = counter - task->lastCounter;
+        task->lastCounter = counter;
+        // Smooth, so a single busy period doesn't move a task.
+        task->recent = task->recent / 2 + delta / 2;
+
+        UBaseType_t mask = vTaskCoreAffinityGet(handle);
+        if(!task->manual && mask != task->assigned) {
+            // Someone else changed the affinity, leave it to them.
+            task->manual = true;
+        }
+        int core = singleCore(mask);
+        if(core >= 0) loads[core] += task->recent;
+    }
+
+    // Place new tasks on the least loaded core.
+    for(LoadBalanced* task = tasks; task; task = task->link) {
+        if(!task->sampled || !task->managed.getTaskHandle()) continue;
+        if(task->manual || task->assigned != tskNO_AFFINITY) continue;
+        unsigned lo = 0;
+        for(unsigned i = 1; i < FREERTOSCPP_CORES; ++i) {
+            if(loads[i] < loads[lo]) lo = i;
+        }
+        place(*task, lo);
+    }
+
+    unsigned hi = 0;
+    unsigned lo = 0;
+    for(unsigned i = 1; i < FREERTOSCPP_CORES; ++i) {
+        if(loads[i] > loads[hi]) hi = i;
+        if(loads[i] < loads[lo]) lo = i;
+    }
+    configRUN_TIME_COUNTER_TYPE diff = loads[hi] - loads[lo];
+    if(diff == 0 || diff <= loads[hi] / 100 * tolerance) return;
+
+    // Moving a task of load l changes the imbalance to |diff - 2l|, so the best is the one
+    // closest to diff/2, and any with 0 < l < diff is an improvement.
+    LoadBalanced* best = nullptr;
+    configRUN_TIME_COUNTER_TYPE bestError = diff;
+    for(LoadBalanced* task = tasks; task; task = task->link) {
+        if(!task->sampled || !task->managed.getTaskHandle()) continue;
+        if(task->manual || task->assigned != (UBaseType_t(1) << hi)) continue;
+        if(task->recent == 0 || task->recent >= diff) continue;
+        configRUN_TIME_COUNTER_TYPE twice = 2 * task->recent;
+        configRUN_TIME_COUNTER_TYPE error = twice > diff ? twice - diff : diff - twice;
+        if(error < bestError) {
+            best = task;
+            bestError = error;
+        }
+    }
+    if(best) {
+        loads[hi] -= best->recent;
+        place(*best, lo);
+        best->moveCount++;
+        moveCount++;
+    }
+}
+
+#endif // FREERTOSCPP_CORES > 1 && configUSE_CORE_AFFINITY && configGENERATE_RUN_TIME_STATS
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file LoadBalancer.h
+ * @brief SMP Load Balancing by Task Affinity
+ *
+ * On SMP kernels unpinned tasks migrate freely between cores, losing their cache state,
+ * while pinning them by hand tends to leave the cores unevenly loaded. The LoadBalancer
+ * samples the run time of its registered tasks and adjusts their core affinities to even
+ * out the load, moving as few tasks as it can.
+ *
+ * Requires configNUMBER_OF_CORES > 1, configUSE_CORE_AFFINITY and configGENERATE_RUN_TIME_STATS.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_LOADBALANCER_H_
+#define FREERTOSPP_LOADBALANCER_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if FREERTOSCPP_CORES > 1 && configUSE_CORE_AFFINITY && configGENERATE_RUN_TIME_STATS
+
+class LoadBalancerBase;
+
+/**
+ * @brief A Task Placed by a LoadBalancer.
+ *
+ * Registers the task with the balancer, which will pin it to a single core, and move it
+ * when that evens out the load.
+ *
+ * A task whose affinity was already restricted when registered, or is changed by anything
+ * other than the balancer (including pin()), is treated as pinned by hand: it is left
+ * where it is, but its load still counts towards its core if pinned to just one.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class LoadBalanced {
+    friend class LoadBalancerBase;
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param balancer_ The balancer that will place the task.
+     * @param task_ The task to place. It need not exist yet, it is left alone while it has no
+     * handle, and first sampled by the balance after it appears.
+     */
+    LoadBalanced(LoadBalancerBase& balancer_, TaskBase& task_);
+    /**
+     * @brief Destructor
+     *
+     * Removes the task from the balancer, leaving its affinity as it is.
+     */
+    virtual ~LoadBalanced();
+
+    TaskBase&   task() const { return managed; }
+    /**
+     * @brief Smoothed run time used per balance period.
+     */
+    configRUN_TIME_COUNTER_TYPE load() const { return recent; }
+    /**
+     * @brief Is the task pinned by hand, and so left alone.
+     */
+    bool        handPinned() const { return manual; }
+    /**
+     * @brief Number of times the balancer has moved the task.
+     */
+    uint32_t    migrations() const { return moveCount; }
+
+    /**
+     * @brief Pin the task by hand, taking it out of balancing. The task must exist.
+     * @param mask The core affinity mask to give the task.
+     */
+    void        pin(UBaseType_t mask);
+    /**
+     * @brief Return a hand pinned task to the balancer. The task must exist.
+     */
+    void        unpin();
+
+private:
+    LoadBalancerBase&           balancer;
+    TaskBase&                   managed;
+    configRUN_TIME_COUNTER_TYPE lastCounter;
+    configRUN_TIME_COUNTER_TYPE recent;
+    UBaseType_t                 assigned;       ///< The mask the balancer last set, tskNO_AFFINITY if not yet placed.
+    uint32_t                    moveCount;
+    bool                        manual;
+    bool                        sampled;        ///< lastCounter and manual have been taken from the task
+    LoadBalanced*               link;
+
+#if __cplusplus < 201101L
+    LoadBalanced(LoadBalanced const&);      ///< We are not copyable.
+    void operator =(LoadBalanced const&);  ///< We are not assignable.
+#else
+    LoadBalanced(LoadBalanced const&) = delete;      ///< We are not copyable.
+    void operator =(LoadBalanced const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Balances the LoadBalanced tasks registered with it.
+ *
+ * Each balance() samples the run time of the tasks, places any not yet pinned on the least
+ * loaded core, and then if the busiest and idlest cores differ by more than the threshold,
+ * moves the one task from the busiest core that best evens them out. Moving at most one
+ * task a pass keeps the rest on the core they have been warming.
+ *
+ * Only the registered tasks are counted, so tasks with significant load should be
+ * registered, even if pinned by hand.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class LoadBalancerBase {
+    friend class LoadBalanced;
+public:
+    /**
+     * @brief Constructor
+     * @param threshold_ Imbalance, in percent of the busiest core's load, to tolerate before moving a task.
+     */
+    LoadBalancerBase(unsigned threshold_ = 20) : tasks(nullptr), loads(), tolerance(threshold_), moveCount(0) {}
+    virtual ~LoadBalancerBase() {}
+
+    /**
+     * @brief Sample the tasks, and re-pin if needed.
+     *
+     * Done in a critical section, as tasks can be registered and removed at any time, so the
+     * time taken grows with the number of registered tasks.
+     */
+    void balance();
+
+    /**
+     * @brief Load on a core at the last balance().
+     */
+    configRUN_TIME_COUNTER_TYPE coreLoad(unsigned core) const { return core < FREERTOSCPP_CORES ? loads[core] : 0; }
+    unsigned    threshold() const { return tolerance; }
+    void        threshold(unsigned threshold_) { tolerance = threshold_; }
+    /**
+     * @brief Number of tasks moved between cores.
+     */
+    uint32_t    migrations() const { return moveCount; }
+
+private:
+    /// Do the balance. Called in a critical section.
+    void rebalance();
+    /// Pin a task to a core.
+    void place(LoadBalanced& task, unsigned core);
+
+    LoadBalanced*               tasks;
+    configRUN_TIME_COUNTER_TYPE loads[FREERTOSCPP_CORES];
+    unsigned                    tolerance;
+    uint32_t                    moveCount;
+
+#if __cplusplus < 201101L
+    LoadBalancerBase(LoadBalancerBase const&);      ///< We are not copyable.
+    void operator =(LoadBalancerBase const&);  ///< We are not assignable.
+#else
+    LoadBalancerBase(LoadBalancerBase const&) = delete;      ///< We are not copyable.
+    void operator =(LoadBalancerBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Load Balancer Task.
+ *
+ * The balance period should be long compared to the tasks' activity, so the loads are
+ * representative, as each move costs the task its cache state.
+ *
+ * Example Usage:
+ * @code
+ * LoadBalancer<200> balancer("Balance", TaskPrio_Mid, pdMS_TO_TICKS(500));
+ * TaskS<512> audio("Audio", &audioTask, TaskPrio_High);
+ * TaskS<512> network("Net", &netTask, TaskPrio_Mid);
+ * LoadBalanced audioPlace(balancer, audio);
+ * LoadBalanced networkPlace(balancer, network);
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth>
+class LoadBalancer : public TaskClassS<stackDepth>, public LoadBalancerBase {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task.
+     * @param period_ How often to balance, in ticks.
+     * @param threshold_ Imbalance, in percent, to tolerate before moving a task.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    LoadBalancer(char const* name, TaskPriority priority_, TickType_t period_, unsigned threshold_ = 20, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_),
+        LoadBalancerBase(threshold_),
+        period(period_ ? period_ : 1)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    void task() override {
+        TickType_t last = xTaskGetTickCount();
+        while(1) {
+            TaskBase::delayUntil(last, period);
+            balance();
+        }
+    }
+
+private:
+    TickType_t  period;
+};
+
+#endif // FREERTOSCPP_CORES > 1 && configUSE_CORE_AFFINITY && configGENERATE_RUN_TIME_STATS
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_LOADBALANCER_H_ */
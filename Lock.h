@@ -155,6 +155,81 @@ private:
 #endif // __cplusplus
 };
 
+/**
+ * Typed version of Lock.
+ *
+ * Works like Lock, but knows the type of the Lockable, so with a final Lockable
+ * (like the spin locks) the take() and give() calls aren't virtual, and can be inlined.
+ * That matters for locks held for only a few instructions.
+ *
+ * @code
+ *  {
+ *      TypedLock<TicketSpinLock> lock(spinLock);
+ *  ...
+ *  }
+ * @endcode
+ *
+ * @tparam L The type of Lockable.
+ * @ingroup FreeRTOSCpp
+ */
+template<class L> class TypedLock {
+public:
+    /**
+     * Constructor
+     * @param mylockable The Lockable object to use
+     * @param mylocked Should we start by taking the lock
+     * @param wait How long to wait to take the lock
+     */
+    TypedLock(L& mylockable, bool mylocked = true, TickType_t wait = portMAX_DELAY) :
+        lockable(mylockable),
+        lockCnt(0)
+    {
+        if(mylocked) lock(wait);
+    }
+    /**
+     * Destructor, releases the lock if held.
+     */
+    ~TypedLock() {
+        if(lockCnt > 0) lockable.give();
+    }
+
+    /**
+     * Try to take the lock. Nested calls need to be unlocked as many times as taken.
+     * @param wait How long to wait in Ticks
+     * @return true if lock has been taken
+     */
+    bool lock(TickType_t wait = portMAX_DELAY) {
+        if(lockCnt > 0 || lockable.take(wait)) {
+            lockCnt++;
+            return true;
+        }
+        return false;
+    }
+    /**
+     * Release a lock
+     */
+    void unlock() {
+        if(lockCnt > 0 && --lockCnt == 0) lockable.give();
+    }
+    /**
+     * Do we have the lock?
+     * @return True if we have the lock.
+     */
+    bool locked() const { return lockCnt > 0; }
+
+private:
+    L&      lockable;   ///< The Lockable object we are connected to
+    int     lockCnt;    ///< The number of locks we hold on lockable.
+
+#if __cplusplus < 201101L
+    TypedLock(TypedLock const&);                      ///< We are not copyable.
+    void operator =(TypedLock const&);           ///< We are not assignable.
+#else
+    TypedLock(TypedLock const&) = delete;             ///< We are not copyable.
+    void operator =(TypedLock const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
 #if FREERTOSCPP_USE_NAMESPACE
 }   // namespace FreeRTOScpp
 #endif
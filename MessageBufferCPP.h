@@ -40,6 +40,10 @@
 #include "FreeRTOScpp.h"
 
 #include "message_buffer.h"
+#include "Watermark.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 #if FREERTOSCPP_USE_NAMESPACE
 namespace FreeRTOScpp {
@@ -53,26 +57,26 @@ namespace FreeRTOScpp {
  */
 class MessageBufferBase {
 public:
-    MessageBufferBase(MessageBufferHandle_t mbHandle) : msgHandle(mbHandle) {}
+    MessageBufferBase(MessageBufferHandle_t mbHandle) : msgHandle(mbHandle), watermark(nullptr) {}
     virtual ~MessageBufferBase() { }
 
     size_t send(const void* data, size_t len, TickType_t delay = portMAX_DELAY) 
-        {return xMessageBufferSend(msgHandle, data, len, delay);} 
+        {return levelChanged(FREERTOSCPP_PERF_CHECK(xMessageBufferSend(msgHandle, data, len, delay), perfMessageSendFail));} 
 #if FREERTOSCPP_USE_CHRONO
     size_t send(const void* data, size_t len, Time_ms delay) 
-        {return xMessageBufferSend(msgHandle, data, len, ms2ticks(delay));} 
+        {return levelChanged(FREERTOSCPP_PERF_CHECK(xMessageBufferSend(msgHandle, data, len, ms2ticks(delay)), perfMessageSendFail));} 
 #endif        
     size_t send_ISR(const void* data, size_t len, BaseType_t &wasWoken) 
-        {return xMessageBufferSendFromISR(msgHandle, data, len, &wasWoken);} 
+        {return levelChanged_ISR(FREERTOSCPP_PERF_CHECK(xMessageBufferSendFromISR(msgHandle, data, len, &wasWoken), perfMessageSendFail), wasWoken);} 
 
     size_t read(void* data, size_t len, TickType_t delay = portMAX_DELAY) 
-        {return xMessageBufferReceive(msgHandle, data, len, delay);} 
+        {return levelChanged(xMessageBufferReceive(msgHandle, data, len, delay));} 
 #if FREERTOSCPP_USE_CHRONO
     size_t read(void* data, size_t len, Time_ms delay) 
-        {return xMessageBufferReceive(msgHandle, data, len, ms2ticks(delay));} 
+        {return levelChanged(xMessageBufferReceive(msgHandle, data, len, ms2ticks(delay)));} 
 #endif        
     size_t read_ISR(void* data, size_t len, BaseType_t &wasWoken) 
-        {return xMessageBufferReceiveFromISR(msgHandle, data, len, &wasWoken);} 
+        {return levelChanged_ISR(xMessageBufferReceiveFromISR(msgHandle, data, len, &wasWoken), wasWoken);} 
 
     // Message Buffers do not provide "Bytes Available"
 
@@ -86,9 +90,33 @@ public:
 
     /// @brief Resets the buffer to empty
     /// @return True if done, stream can not be reset if a task is waiting on the MessageBuffer.
-    bool reset() { return xMessageBufferReset(msgHandle);}
+    bool reset() {
+        bool ok = xMessageBufferReset(msgHandle);
+        if(ok && watermark) watermark->updateFrom([this] { return xStreamBufferBytesAvailable(msgHandle); });
+        return ok;
+    }
+
+    /// @brief Attach a Watermark to the buffer
+    /// The Watermark is given the number of bytes used (including the message length words) after each send/read.
+    /// @param wm The Watermark, or nullptr to remove it.
+    void setWatermark(Watermark* wm) {
+        watermark = wm;
+        if(wm) wm->update(xStreamBufferBytesAvailable(msgHandle));
+    }
 
     MessageBufferHandle_t msgHandle;
+protected:
+    /// Report the new level to the Watermark after a successful operation.
+    size_t levelChanged(size_t result) {
+        if(result && watermark) watermark->updateFrom([this] { return xStreamBufferBytesAvailable(msgHandle); });
+        return result;
+    }
+    size_t levelChanged_ISR(size_t result, BaseType_t& wasWoken) {
+        if(result && watermark) watermark->updateFrom_ISR([this] { return xStreamBufferBytesAvailable(msgHandle); }, wasWoken);
+        return result;
+    }
+
+    Watermark* watermark;
 };
 
 /**
@@ -157,4 +185,4 @@ public:
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -41,6 +41,9 @@
 
 #include "Lock.h"
 #include "semphr.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 #if FREERTOSCPP_USE_NAMESPACE
 namespace FreeRTOScpp {
@@ -98,11 +101,11 @@ public:
 	}
 
 	bool take(TickType_t wait = portMAX_DELAY) override {
-		return xSemaphoreTake(mutexHandle, wait);
+		return FREERTOSCPP_PERF_CHECK(xSemaphoreTake(mutexHandle, wait), perfMutexTakeFail);
 	}
 #if FREERTOSCPP_USE_CHRONO
     bool take(Time_ms wait) {
-        return xSemaphoreTake(mutexHandle, ms2ticks(wait));
+        return FREERTOSCPP_PERF_CHECK(xSemaphoreTake(mutexHandle, ms2ticks(wait)), perfMutexTakeFail);
     }
 #endif
 
@@ -175,7 +178,7 @@ public:
 	}
 
 	bool take(TickType_t wait = portMAX_DELAY) override {
-		return xSemaphoreTakeRecursive(mutexHandle, wait);
+		return FREERTOSCPP_PERF_CHECK(xSemaphoreTakeRecursive(mutexHandle, wait), perfMutexTakeFail);
 	}
 	bool give() override {
 		return xSemaphoreGiveRecursive(mutexHandle);
@@ -0,0 +1,170 @@
+/**
+ * @file PerfCounters.cpp
+ * @brief Performance Counter Registry
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "PerfCounters.h"
+#include <string.h>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+PerfMetric* PerfMetric::head = nullptr;
+
+PerfMetric::PerfMetric(char const* name_, PerfMetricType type_) :
+metricName(name_),
+metricType(type_)
+{
+    taskENTER_CRITICAL();
+    link = head;
+    head = this;
+    taskEXIT_CRITICAL();
+}
+
+PerfMetric::~PerfMetric() {
+    taskENTER_CRITICAL();
+    PerfMetric** ptr = &head;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    taskEXIT_CRITICAL();
+}
+
+PerfMetric* PerfMetric::find(char const* name) {
+    for(PerfMetric* metric = head; metric; metric = metric->link) {
+        if(strcmp(metric->metricName, name) == 0) return metric;
+    }
+    return nullptr;
+}
+
+void PerfWriter::jsonString(char const* str) {
+    byte('"');
+    while(*str) {
+        char c = *str++;
+        if(c == '"' || c == '\\') byte('\\');
+        byte(c);
+    }
+    byte('"');
+}
+
+void PerfWriter::decimal(uint32_t val) {
+    char digits[10];
+    int cnt = 0;
+    do {
+        digits[cnt++] = '0' + val % 10;
+        val /= 10;
+    } while(val);
+    while(cnt) byte(digits[--cnt]);
+}
+
+void PerfWriter::decimal(int32_t val) {
+    if(val < 0) {
+        byte('-');
+        decimal(static_cast<uint32_t>(0) - static_cast<uint32_t>(val));
+    } else {
+        decimal(static_cast<uint32_t>(val));
+    }
+}
+
+void PerfCounter::writeJson(PerfWriter& out) const {
+    out.text(",\"value\":");
+    out.decimal(value());
+}
+
+void PerfGauge::writeJson(PerfWriter& out) const {
+    out.text(",\"value\":");
+    out.decimal(value());
+}
+
+void PerfHistogramBase::writeBinary(PerfWriter& out) const {
+    // The histogram may be recording while we export, so its size measured first might not
+    // be what is then written. Serialize once, after room for the longest length prefix,
+    // then move the data down to follow the prefix for the length actually written.
+    uint8_t prefix[5];
+    size_t room = out.space();
+    size_t len = room > sizeof(prefix) ? serialize(out.next() + sizeof(prefix), room - sizeof(prefix)) : 0;
+    if(len == 0) {
+        out.skip(room + 1);     // Mark as overflowed
+        return;
+    }
+    PerfWriter lenOut(prefix, sizeof(prefix));
+    lenOut.varint(len);
+    memmove(out.next() + lenOut.size(), out.next() + sizeof(prefix), len);
+    out.bytes(prefix, lenOut.size());
+    out.skip(len);
+}
+
+void PerfHistogramBase::writeSummary(PerfWriter& out) const {
+    out.varint(count());
+    out.varint(percentile(50));
+    out.varint(percentile(90));
+    out.varint(percentile(99));
+    out.varint(max());
+}
+
+void PerfHistogramBase::writeJson(PerfWriter& out) const {
+    out.text(",\"count\":");
+    out.decimal(count());
+    out.text(",\"p50\":");
+    out.decimal(percentile(50));
+    out.text(",\"p90\":");
+    out.decimal(percentile(90));
+    out.text(",\"p99\":");
+    out.decimal(percentile(99));
+    out.text(",\"max\":");
+    out.decimal(max());
+}
+
+#if FREERTOSCPP_USE_PERF_COUNTERS
+PerfCounter perfQueueSendFail("queue.send_fail");
+PerfCounter perfQueueReceiveFail("queue.recv_fail");
+PerfCounter perfSemaphoreTakeFail("sem.take_fail");
+PerfCounter perfMutexTakeFail("mutex.take_fail");
+PerfCounter perfStreamSendFail("stream.send_fail");
+PerfCounter perfMessageSendFail("msg.send_fail");
+PerfCounter perfTimerCommandFail("timer.cmd_fail");
+PerfCounter perfTaskCreateFail("task.create_fail");
+PerfCounter perfContextSwitches("sched.switches");
+
+extern "C" void freertoscpp_task_switched_in(void) {
+    perfContextSwitches.increment();
+}
+#endif
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
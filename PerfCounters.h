@@ -0,0 +1,365 @@
+/**
+ * @file PerfCounters.h
+ * @brief Performance Counter Registry
+ *
+ * This file provides named performance counters, gauges and histograms, that register
+ * themselves in a central list when constructed, so modules can just declare them statically
+ * and an exporter (see PerfExporter.h) can find and report them.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_PERFCOUNTERS_H_
+#define FREERTOSPP_PERFCOUNTERS_H_
+
+#include "FreeRTOScpp.h"
+#include "LatencyHistogram.h"
+#include "Atomic.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if FREERTOSCPP_USE_PERF_COUNTERS
+extern "C" {
+    /**
+     * @brief Trace hook to count context switches in perfContextSwitches.
+     *
+     * To use, add to FreeRTOSConfig.h:
+     * @code
+     * extern void freertoscpp_task_switched_in(void);
+     * #define traceTASK_SWITCHED_IN() freertoscpp_task_switched_in()
+     * @endcode
+     */
+    extern void freertoscpp_task_switched_in(void);
+}
+#endif
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * Types of Performance Metrics
+ *
+ * The values are used in the binary export format.
+ * @ingroup FreeRTOSCpp
+ */
+enum PerfMetricType : uint8_t {
+    PerfType_Counter = 1,           ///< Monotonic count of events
+    PerfType_Gauge = 2,             ///< Signed value that is set to the current state
+    PerfType_Histogram = 3,         ///< Distribution of values, full buckets
+    PerfType_HistogramSummary = 4,  ///< Distribution of values, summary only (used if the buckets won't fit)
+    PerfType_End = 0xFF             ///< End of snapshot marker
+};
+
+/**
+ * @brief Bounded buffer writer used to serialize metrics.
+ *
+ * Writes past the end of the buffer are dropped and mark the writer as overflowed, so the
+ * code building a record doesn't need to check every write.
+ * @ingroup FreeRTOSCpp
+ */
+class PerfWriter {
+public:
+    PerfWriter(uint8_t* buf_, size_t len_) : buf(buf_), len(len_), pos(0), overflow(false) {}
+
+    void byte(uint8_t val) {
+        if(pos < len) buf[pos++] = val; else overflow = true;
+    }
+    void bytes(void const* data, size_t cnt) {
+        uint8_t const* src = static_cast<uint8_t const*>(data);
+        while(cnt--) byte(*src++);
+    }
+    /// Write unsigned LEB128 varint
+    void varint(uint32_t val) {
+        do {
+            uint8_t b = val & 0x7F;
+            val >>= 7;
+            byte(val ? (b | 0x80) : b);
+        } while(val);
+    }
+    /// Write signed value as a zigzag encoded varint
+    void svarint(int32_t val) {
+        varint((static_cast<uint32_t>(val) << 1) ^ static_cast<uint32_t>(val >> 31));
+    }
+    /// Write string text (no terminator)
+    void text(char const* str) {
+        while(*str) byte(*str++);
+    }
+    /// Write string as a JSON string, with quotes and escapes
+    void jsonString(char const* str);
+    /// Write decimal text of a number
+    void decimal(int32_t val);
+    void decimal(uint32_t val);
+
+    /**
+     * @brief Get space left in the buffer
+     */
+    size_t space() const { return len - pos; }
+    /**
+     * @brief Get pointer to the next byte to write, for in place writes
+     */
+    uint8_t* next() { return buf + pos; }
+    /**
+     * @brief Advance over bytes written in place
+     */
+    void skip(size_t cnt) { if(cnt <= space()) pos += cnt; else overflow = true; }
+
+    size_t size() const { return pos; }
+    bool overflowed() const { return overflow; }
+    /**
+     * @brief Empty the buffer, to start a new record
+     */
+    void clear() { pos = 0; overflow = false; }
+    uint8_t const* data() const { return buf; }
+private:
+    uint8_t*    buf;
+    size_t      len;
+    size_t      pos;
+    bool        overflow;
+};
+
+/**
+ * @brief Base of all Performance Metrics
+ *
+ * On construction the metric adds itself to the registry, and on destruction removes itself.
+ * Normally the metrics are static objects, so are registered before main() is called.
+ *
+ * The name is not copied, so must outlive the metric, normally it is a string literal. For the JSON
+ * format, names are best limited to identifier characters and '.'.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class PerfMetric {
+protected:
+    PerfMetric(char const* name_, PerfMetricType type_);
+public:
+    virtual ~PerfMetric();
+
+    char const*     name() const { return metricName; }
+    PerfMetricType  type() const { return metricType; }
+
+    /**
+     * @brief Write the value of the metric in the binary format.
+     *
+     * The caller has written the type and name.
+     */
+    virtual void    writeBinary(PerfWriter& out) const = 0;
+    /**
+     * @brief Write the value of the metric in JSON
+     *
+     * The caller has written the name and type members of the object, this adds the rest.
+     */
+    virtual void    writeJson(PerfWriter& out) const = 0;
+    /**
+     * @brief Reset the metric to its initial state.
+     */
+    virtual void    reset() = 0;
+
+    /**
+     * @brief Get the first registered metric.
+     *
+     * Metrics are only expected to be added/removed during system setup, while walking
+     * the list metrics should not be destroyed.
+     */
+    static PerfMetric* first() { return head; }
+    /**
+     * @brief Get the next metric on the list, nullptr at the end.
+     */
+    PerfMetric*     next() const { return link; }
+
+    /**
+     * @brief Find a metric by name
+     * @return The metric, or nullptr if not found.
+     */
+    static PerfMetric* find(char const* name);
+
+private:
+    char const*     metricName;
+    PerfMetricType  metricType;
+    PerfMetric*     link;
+    static PerfMetric* head;
+
+#if __cplusplus < 201101L
+    PerfMetric(PerfMetric const&);      ///< We are not copyable.
+    void operator =(PerfMetric const&);  ///< We are not assignable.
+#else
+    PerfMetric(PerfMetric const&) = delete;      ///< We are not copyable.
+    void operator =(PerfMetric const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Event Counter.
+ *
+ * A monotonic (wrapping) count of events. Incrementing is a relaxed atomic add, so is
+ * usable from tasks and ISRs. On SMP builds each core counts into its own shard, and the
+ * shards are summed when read.
+ *
+ * Example Usage:
+ * @code
+ * PerfCounter rxFrames("uart.rx_frames");
+ *
+ * // In the driver
+ * rxFrames.increment();
+ * @endcode
+ * @ingroup FreeRTOSCpp
+ */
+class PerfCounter : public PerfMetric {
+public:
+    PerfCounter(char const* name_) : PerfMetric(name_, PerfType_Counter) { reset(); }
+
+    void increment() { add(1); }
+    void add(uint32_t cnt) {
+        shard[currentCore()].fetch_add(cnt, std::memory_order_relaxed);
+    }
+    uint32_t value() const {
+        uint32_t total = 0;
+        for(unsigned i = 0; i < FREERTOSCPP_CORES; i++) total += shard[i].load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void writeBinary(PerfWriter& out) const override { out.varint(value()); }
+    void writeJson(PerfWriter& out) const override;
+    void reset() override {
+        for(unsigned i = 0; i < FREERTOSCPP_CORES; i++) shard[i].store(0, std::memory_order_relaxed);
+    }
+private:
+    Atomic<uint32_t, Atomic_IsrSafe>    shard[FREERTOSCPP_CORES];
+};
+
+/**
+ * @brief Gauge
+ *
+ * A value that reflects a current state (queue depth, free heap, ...).
+ * Updates are relaxed atomics, so are usable from tasks and ISRs.
+ * @ingroup FreeRTOSCpp
+ */
+class PerfGauge : public PerfMetric {
+public:
+    PerfGauge(char const* name_) : PerfMetric(name_, PerfType_Gauge) { reset(); }
+
+    void set(int32_t val) { gauge.store(val, std::memory_order_relaxed); }
+    void add(int32_t val) { gauge.fetch_add(val, std::memory_order_relaxed); }
+    int32_t value() const { return gauge.load(std::memory_order_relaxed); }
+
+    void writeBinary(PerfWriter& out) const override { out.svarint(value()); }
+    void writeJson(PerfWriter& out) const override;
+    void reset() override { set(0); }
+private:
+    Atomic<int32_t, Atomic_IsrSafe>     gauge;
+};
+
+/**
+ * @brief Base of Registered Histograms
+ *
+ * Provides the export of a histogram, independent of the bucket layout.
+ * @ingroup FreeRTOSCpp
+ */
+class PerfHistogramBase : public PerfMetric {
+protected:
+    PerfHistogramBase(char const* name_) : PerfMetric(name_, PerfType_Histogram) {}
+public:
+    virtual uint32_t count() const = 0;
+    virtual uint32_t percentile(uint32_t part, uint32_t whole = 100) const = 0;
+    virtual uint32_t max() const = 0;
+    /**
+     * @brief Serialize the buckets, see HistogramBase::serialize()
+     */
+    virtual size_t   serialize(uint8_t* buf, size_t len) const = 0;
+
+    void writeBinary(PerfWriter& out) const override;
+    /**
+     * @brief Write the summary (count, p50, p90, p99, max) used if the full buckets won't fit.
+     */
+    void writeSummary(PerfWriter& out) const;
+    void writeJson(PerfWriter& out) const override;
+};
+
+/**
+ * @brief Registered Latency Histogram
+ *
+ * A ShardedLatencyHistogram that is part of the registry.
+ *
+ * @tparam subBits      Number of bits of resolution kept within each power of two.
+ * @tparam valueBits    Number of significant bits in the largest recordable value.
+ * @ingroup FreeRTOSCpp
+ */
+template<unsigned subBits = 3, unsigned valueBits = 32>
+class PerfHistogram : public PerfHistogramBase, public ShardedLatencyHistogram<subBits, valueBits> {
+    typedef ShardedLatencyHistogram<subBits, valueBits> Histogram;
+public:
+    PerfHistogram(char const* name_) : PerfHistogramBase(name_) {}
+
+    using Histogram::record;
+
+    uint32_t count() const override { return Histogram::count(); }
+    uint32_t percentile(uint32_t part, uint32_t whole = 100) const override { return Histogram::percentile(part, whole); }
+    uint32_t max() const override { return Histogram::max(); }
+    size_t   serialize(uint8_t* buf, size_t len) const override { return Histogram::serialize(buf, len); }
+    void     reset() override { Histogram::reset(); }
+};
+
+/**
+ * @brief Count a failed operation.
+ *
+ * Used by FREERTOSCPP_PERF_CHECK in the wrapper classes.
+ *
+ * @param result The result of the operation, a false/zero result is a failure.
+ * @param counter The counter to increment on failure.
+ * @returns result
+ */
+template<class T> inline T perfCheck(T result, PerfCounter& counter) {
+    if(!result) counter.increment();
+    return result;
+}
+
+#if FREERTOSCPP_USE_PERF_COUNTERS
+/**
+ * @name Built in counters for the wrapper classes.
+ * Only present if FREERTOSCPP_USE_PERF_COUNTERS is non-zero.
+ * @{
+ */
+extern PerfCounter perfQueueSendFail;       ///< "queue.send_fail" Queue push/add that timed out or found the Queue full
+extern PerfCounter perfQueueReceiveFail;    ///< "queue.recv_fail" Queue pop that timed out
+extern PerfCounter perfSemaphoreTakeFail;   ///< "sem.take_fail" Semaphore take that timed out
+extern PerfCounter perfMutexTakeFail;       ///< "mutex.take_fail" Mutex take that timed out
+extern PerfCounter perfStreamSendFail;      ///< "stream.send_fail" StreamBuffer send that sent nothing
+extern PerfCounter perfMessageSendFail;     ///< "msg.send_fail" MessageBuffer send that failed
+extern PerfCounter perfTimerCommandFail;    ///< "timer.cmd_fail" Timer command that couldn't be queued
+extern PerfCounter perfTaskCreateFail;      ///< "task.create_fail" Task that couldn't be created
+extern PerfCounter perfContextSwitches;     ///< "sched.switches" Context switches, needs the trace hook below
+/** @} */
+#endif
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_PERFCOUNTERS_H_ */
@@ -0,0 +1,140 @@
+/**
+ * @file PerfExporter.cpp
+ * @brief Performance Counter Exporter Task
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "PerfExporter.h"
+#include <string.h>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+static char const* const jsonTypeNames[] = {
+    "", "counter", "gauge", "histogram", "histogram"
+};
+
+bool PerfExporterBase::send(PerfWriter& out, size_t reserve) {
+    // Only send whole records, and keep room for the terminator, so a snapshot cut short
+    // can still be ended validly. We are the only writer, so the room can only grow.
+    size_t need = out.size() + reserve;
+    TimeOut_t timeout;
+    TickType_t wait = sendWait;
+    vTaskSetTimeOutState(&timeout);
+    while(stream.available() < need) {
+        if(xTaskCheckForTimeOut(&timeout, &wait) != pdFALSE) {
+            dropped++;
+            out.clear();
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    stream.send(out.data(), out.size(), 0);
+    out.clear();
+    return true;
+}
+
+bool PerfExporterBase::exportSnapshot(uint8_t* buffer, size_t size) {
+    PerfWriter out(buffer, size);
+    bool ok = true;
+    TickType_t now = xTaskGetTickCount();
+    size_t const reserve = format == PerfFormat_Binary ? 1 : 3;     // PerfType_End or "]}\n"
+
+    if(format == PerfFormat_Binary) {
+        out.byte('P');
+        out.byte('C');
+        out.byte(1);
+        for(unsigned i = 0; i < 4; i++) {
+            out.byte(static_cast<uint32_t>(now) >> (8 * i));
+        }
+    } else {
+        out.text("{\"tick\":");
+        out.decimal(static_cast<uint32_t>(now));
+        out.text(",\"metrics\":[");
+    }
+    // No room for even the header, so send nothing rather than a fragment.
+    if(!send(out, reserve)) return false;
+
+    bool firstMetric = true;
+    for(PerfMetric* metric = PerfMetric::first(); metric; metric = metric->next()) {
+        if(format == PerfFormat_Binary) {
+            size_t nameLen = strlen(metric->name());
+            if(nameLen > 255) nameLen = 255;
+            out.byte(metric->type());
+            out.byte(nameLen);
+            out.bytes(metric->name(), nameLen);
+            metric->writeBinary(out);
+            if(out.overflowed() && metric->type() == PerfType_Histogram) {
+                // Buckets won't fit, send the summary instead.
+                out.clear();
+                out.byte(PerfType_HistogramSummary);
+                out.byte(nameLen);
+                out.bytes(metric->name(), nameLen);
+                static_cast<PerfHistogramBase*>(metric)->writeSummary(out);
+            }
+        } else {
+            if(!firstMetric) out.byte(',');
+            out.text("{\"name\":");
+            out.jsonString(metric->name());
+            out.text(",\"type\":\"");
+            out.text(jsonTypeNames[metric->type() <= PerfType_HistogramSummary ? metric->type() : 0]);
+            out.byte('"');
+            metric->writeJson(out);
+            out.byte('}');
+        }
+        if(out.overflowed()) {
+            // Too big for the buffer even in summary form, leave just this one out.
+            dropped++;
+            ok = false;
+            out.clear();
+            continue;
+        }
+        if(!send(out, reserve)) {
+            // Stream is full, end the snapshot here.
+            ok = false;
+            break;
+        }
+        firstMetric = false;
+    }
+
+    if(format == PerfFormat_Binary) {
+        out.byte(PerfType_End);
+    } else {
+        out.text("]}\n");
+    }
+    ok &= send(out, 0);
+    return ok;
+}
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
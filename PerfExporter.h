@@ -0,0 +1,203 @@
+/**
+ * @file PerfExporter.h
+ * @brief Performance Counter Exporter Task
+ *
+ * A low priority task that periodically takes a snapshot of all the registered
+ * performance metrics (see PerfCounters.h) and writes it to a StreamBuffer for
+ * some other task (a console, a network link, ...) to send on.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_PERFEXPORTER_H_
+#define FREERTOSPP_PERFEXPORTER_H_
+
+#include "PerfCounters.h"
+#include "StreamBufferCPP.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * Export Formats
+ * @ingroup FreeRTOSCpp
+ */
+enum PerfFormat {
+    PerfFormat_Binary,      ///< Compact binary, see PerfExporterBase::exportSnapshot()
+    PerfFormat_Json         ///< One line of JSON per snapshot
+};
+
+/**
+ * @brief Performance Metric Exporter
+ *
+ * Does the work of walking the registry and serializing the metrics.
+ * Each metric is built as a record in the provided buffer, and then sent as a unit
+ * to the StreamBuffer.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class PerfExporterBase {
+public:
+    /**
+     * @brief Constructor
+     * @param stream_ The StreamBuffer to write the snapshots to.
+     * @param format_ The format to write the snapshots in.
+     * @param sendWait_ How long to wait for room in the StreamBuffer for each record.
+     */
+    PerfExporterBase(StreamBufferBase& stream_, PerfFormat format_, TickType_t sendWait_) :
+        stream(stream_), format(format_), sendWait(sendWait_), dropped(0) {}
+    virtual ~PerfExporterBase() {}
+
+    /**
+     * @brief Export a snapshot of all the metrics
+     *
+     * Binary Format:
+     * + Header: 'P', 'C', version (1), tick count as 4 byte little endian
+     * + For each metric:
+     *   + 1 byte PerfMetricType
+     *   + 1 byte name length, then the name (no terminator)
+     *   + Counter: LEB128 varint value
+     *   + Gauge: zigzag LEB128 varint value
+     *   + Histogram: LEB128 varint length, then the LatencyHistogram::serialize() data
+     *   + Histogram Summary: LEB128 varints count, p50, p90, p99, max
+     * + End: 1 byte PerfType_End
+     *
+     * JSON Format:
+     * @code
+     * {"tick":1234,"metrics":[{"name":"queue.send_fail","type":"counter","value":0}, ...]}
+     * @endcode
+     * followed by a newline.
+     *
+     * Room for the end marker is kept in the StreamBuffer, so if it fills part way through,
+     * the snapshot is ended early but is still well formed. A metric too big for the buffer
+     * is left out.
+     *
+     * @param buffer Working buffer to build records in.
+     * @param size Size of the working buffer, needs to hold the largest record.
+     * @return true if all the records were sent.
+     */
+    bool exportSnapshot(uint8_t* buffer, size_t size);
+
+    /**
+     * @brief Number of records that couldn't be sent (StreamBuffer full or record too big)
+     */
+    uint32_t droppedRecords() const { return dropped; }
+
+protected:
+    /// Send a record, if it fits in the StreamBuffer leaving reserve bytes free.
+    bool send(PerfWriter& out, size_t reserve);
+
+    StreamBufferBase&   stream;
+    PerfFormat          format;
+    TickType_t          sendWait;
+    uint32_t            dropped;
+};
+
+/**
+ * @brief Performance Metric Exporter Task
+ *
+ * Exports a snapshot every period, and also when triggered with give()/trigger().
+ *
+ * Example Usage:
+ * @code
+ * StreamBuffer<512> perfStream;
+ * PerfExporter<256> perfExporter("Perf", TaskPrio_Low, perfStream, 1000, PerfFormat_Json);
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @tparam bufferSize Size of the buffer used to build each record in. If a histogram won't fit
+ * it will be exported as a summary.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth, size_t bufferSize = 128>
+class PerfExporter : public TaskClassS<stackDepth>, public PerfExporterBase {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task, normally low.
+     * @param stream_ The StreamBuffer to write the snapshots to.
+     * @param period_ The period in ticks between exports, 0 for only on trigger.
+     * @param format_ The format to write the snapshots in.
+     * @param sendWait_ How long to wait for room in the StreamBuffer for each record.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    PerfExporter(char const* name, TaskPriority priority_, StreamBufferBase& stream_, TickType_t period_,
+                 PerfFormat format_ = PerfFormat_Binary, TickType_t sendWait_ = 0, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_),
+        PerfExporterBase(stream_, format_, sendWait_),
+        period(period_)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    /**
+     * @brief Request an immediate export, the periodic schedule is not changed.
+     */
+    void trigger() { this->give(); }
+
+    void task() override {
+        TickType_t next = xTaskGetTickCount() + period;
+        while(1) {
+            TickType_t wait = portMAX_DELAY;
+            if(period) {
+                TickType_t now = xTaskGetTickCount();
+                wait = next - now;
+                if(wait > period) {
+                    // Fallen behind, resync rather than burst out the missed exports
+                    next = now;
+                    wait = 0;
+                }
+            }
+            if(TaskBase::take(true, wait) == 0) {
+                // Timeout, so a periodic export
+                next += period;
+            }
+            exportSnapshot(buffer, bufferSize);
+        }
+    }
+
+private:
+    TickType_t  period;
+    uint8_t     buffer[bufferSize];
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_PERFEXPORTER_H_ */
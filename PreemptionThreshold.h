@@ -0,0 +1,203 @@
+/**
+ * @file PreemptionThreshold.h
+ * @brief Preemption Threshold for Tasks
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_PREEMPTIONTHRESHOLD_H_
+#define FREERTOSPP_PREEMPTIONTHRESHOLD_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if INCLUDE_vTaskPrioritySet && INCLUDE_uxTaskPriorityGet
+/**
+ * @brief Preemption Threshold for a Task.
+ *
+ * Emulates the ThreadX preemption threshold. The task is scheduled at its normal priority,
+ * but while it is running a window of work it can only be preempted by tasks with a
+ * priority above its threshold. This stops tightly coupled tasks (like a producer and
+ * consumer pair) preempting each other on every operation.
+ *
+ * This is done by raising the task to the threshold priority for the window, and
+ * dropping back to its normal priority at the end of the window. The window should be
+ * closed before the task blocks, otherwise it blocks at the threshold priority. Note
+ * that with configUSE_TIME_SLICING tasks at the threshold priority will still be time
+ * sliced with the task.
+ *
+ * The normal priority is recorded at construction (or set with priority()) rather than
+ * read at the start of the window, so a priority inherited from a Mutex isn't taken
+ * as the normal priority.
+ *
+ * To measure the effect, enable FREERTOSCPP_USE_PERF_COUNTERS and the
+ * traceTASK_SWITCHED_IN hook, and compare perfContextSwitches with and without the threshold.
+ *
+ * Example Usage:
+ * @code
+ * class Consumer : public TaskClassS<256> {
+ *     PreemptionThreshold threshold;
+ * public:
+ *     Consumer() : TaskClassS<256>("Consumer", TaskPrio_Low), threshold(*this, TaskPrio_Mid) { ... }
+ *     void task() override {
+ *         while(1) {
+ *             Item item;
+ *             queue.pop(item);                // Blocks at the normal priority
+ *             PreemptionThreshold::Window window(threshold);
+ *             process(item);                  // Not preempted by the producer at TaskPrio_Mid
+ *         }
+ *     }
+ * };
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class PreemptionThreshold {
+public:
+    /**
+     * @brief Constructor
+     * @param task_ The task to apply the threshold to.
+     * @param threshold_ The priority a task needs to be above to preempt the task in a window.
+     */
+    PreemptionThreshold(TaskBase& task_, TaskPriority threshold_) :
+        task(task_),
+        basePriority(task_.priority()),
+        thresholdPriority(threshold_),
+        nesting(0),
+        windows(0)
+    {}
+
+    /**
+     * @brief Start a window of work, raising the task to its threshold.
+     *
+     * Windows may nest, only the outermost changes the priority.
+     * Should only be called by the task itself.
+     */
+    void enter() {
+        if(nesting++ == 0) {
+            windows++;
+            if(thresholdPriority > basePriority) {
+                task.priority(thresholdPriority);
+            }
+        }
+    }
+
+    /**
+     * @brief End a window of work, restoring the task's normal priority.
+     *
+     * Should be called before the task blocks.
+     */
+    void exit() {
+        configASSERT(nesting > 0);
+        if(--nesting == 0) {
+            if(thresholdPriority > basePriority) {
+                task.priority(basePriority);
+            }
+        }
+    }
+
+    /**
+     * @brief Are we in a window.
+     */
+    bool inWindow() const { return nesting > 0; }
+
+    /**
+     * @brief Get the normal priority of the task.
+     */
+    TaskPriority priority() const { return basePriority; }
+    /**
+     * @brief Change the normal priority of the task.
+     *
+     * If not in a window, the task's priority is changed now, otherwise at the end of the window.
+     */
+    void priority(TaskPriority priority_) {
+        basePriority = priority_;
+        if(nesting == 0 || thresholdPriority <= basePriority) task.priority(basePriority);
+    }
+
+    /**
+     * @brief Get the threshold.
+     */
+    TaskPriority threshold() const { return thresholdPriority; }
+    /**
+     * @brief Change the threshold, takes effect at the next window.
+     */
+    void threshold(TaskPriority threshold_) { thresholdPriority = threshold_; }
+
+    /**
+     * @brief Number of windows run.
+     */
+    uint32_t windowCount() const { return windows; }
+
+    /**
+     * @brief RAII window, raises the task to its threshold for the life of the object.
+     */
+    class Window {
+    public:
+        Window(PreemptionThreshold& threshold_) : threshold(threshold_) { threshold.enter(); }
+        ~Window() { threshold.exit(); }
+    private:
+        PreemptionThreshold& threshold;
+
+#if __cplusplus < 201101L
+        Window(Window const&);      ///< We are not copyable.
+        void operator =(Window const&);  ///< We are not assignable.
+#else
+        Window(Window const&) = delete;      ///< We are not copyable.
+        void operator =(Window const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+    };
+
+private:
+    TaskBase&       task;
+    TaskPriority    basePriority;
+    TaskPriority    thresholdPriority;
+    unsigned        nesting;
+    uint32_t        windows;
+
+#if __cplusplus < 201101L
+    PreemptionThreshold(PreemptionThreshold const&);      ///< We are not copyable.
+    void operator =(PreemptionThreshold const&);  ///< We are not assignable.
+#else
+    PreemptionThreshold(PreemptionThreshold const&) = delete;      ///< We are not copyable.
+    void operator =(PreemptionThreshold const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+#endif // INCLUDE_vTaskPrioritySet && INCLUDE_uxTaskPriorityGet
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_PREEMPTIONTHRESHOLD_H_ */
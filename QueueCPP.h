@@ -38,6 +38,11 @@
 
 #include "FreeRTOScpp.h"
 #include "queue.h"
+#include "Watermark.h"
+#include <type_traits>
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 #if FREERTOSCPP_USE_NAMESPACE
 namespace FreeRTOScpp {
@@ -59,7 +64,7 @@ protected:
 	 * Effectively Abstract class so protected base.
 	 * @param handle_ The queueHandle for the queue/
 	 */
-	QueueBase(QueueHandle_t handle_) : queueHandle(handle_) {};
+	QueueBase(QueueHandle_t handle_) : queueHandle(handle_), watermark(nullptr) {};
 public:
 	  /**
 	   * @brief Destructor.
@@ -90,6 +95,7 @@ public:
 	   */
 	  void reset() {
 		  xQueueReset(queueHandle);
+		  levelChanged(pdTRUE);
 	  }
 
 	  /**
@@ -135,8 +141,32 @@ public:
 	    return uxQueueMessagesWaitingFromISR(queueHandle);
 	  }
 
+	  /**
+	   * @brief Attach a Watermark to the Queue.
+	   * The Watermark is given the number of items waiting after each push/add/pop.
+	   * @param wm The Watermark, or nullptr to remove it.
+	   */
+	  void setWatermark(Watermark* wm) {
+	    watermark = wm;
+	    if(wm) wm->update(waiting());
+	  }
+
 protected:
+	/// Report the new level to the Watermark after a successful operation.
+	/// The level is read with the FromISR call, a plain read of the count, rather than
+	/// uxQueueMessagesWaiting() with its critical section, as it is only compared against the
+	/// thresholds, and Watermark reads it again inside its own critical section if it crosses.
+	BaseType_t levelChanged(BaseType_t result) {
+	    if(result && watermark) watermark->updateFrom([this] { return uxQueueMessagesWaitingFromISR(queueHandle); });
+	    return result;
+	}
+	BaseType_t levelChanged_ISR(BaseType_t result, portBASE_TYPE& waswoken) {
+	    if(result && watermark) watermark->updateFrom_ISR([this] { return uxQueueMessagesWaitingFromISR(queueHandle); }, waswoken);
+	    return result;
+	}
+
 	QueueHandle_t queueHandle;
+	Watermark*    watermark;
 private:
 
 #if __cplusplus < 201101L
@@ -169,7 +199,7 @@ public:
 	   * @return True if successful
 	   */
 	bool push(T const& item, TickType_t time = portMAX_DELAY){
-	    return xQueueSendToFront(queueHandle, &item, time);
+	    return levelChanged(FREERTOSCPP_PERF_CHECK(xQueueSendToFront(queueHandle, &item, time), perfQueueSendFail));
 	}
 #if FREERTOSCPP_USE_CHRONO
     /**
@@ -180,7 +210,7 @@ public:
      * @return True if successful
      */
   bool push(T const& item, Time_ms time){
-      return xQueueSendToFront(queueHandle, &item, ms2ticks(time));
+      return levelChanged(FREERTOSCPP_PERF_CHECK(xQueueSendToFront(queueHandle, &item, ms2ticks(time)), perfQueueSendFail));
   }
 #endif
 	  /**
@@ -191,7 +221,7 @@ public:
 	   * @return True if successful
 	   */
 	  bool add(T const& item, TickType_t time = portMAX_DELAY){
-	    return xQueueSendToBack(queueHandle, &item, time);
+	    return levelChanged(FREERTOSCPP_PERF_CHECK(xQueueSendToBack(queueHandle, &item, time), perfQueueSendFail));
 	  }
 #if FREERTOSCPP_USE_CHRONO
       /**
@@ -202,7 +232,7 @@ public:
        * @return True if successful
        */
       bool add(T const& item, Time_ms time){
-        return xQueueSendToBack(queueHandle, &item, ms2ticks(time));
+        return levelChanged(FREERTOSCPP_PERF_CHECK(xQueueSendToBack(queueHandle, &item, ms2ticks(time)), perfQueueSendFail));
       }
 #endif
 	  /**
@@ -213,7 +243,7 @@ public:
 	   * @return True if an item returned.
 	   */
 	  bool pop(T& var, TickType_t time = portMAX_DELAY) {
-	    return xQueueReceive(queueHandle, &var, time);
+	    return levelChanged(FREERTOSCPP_PERF_CHECK(xQueueReceive(queueHandle, &var, time), perfQueueReceiveFail));
 	  }
 #if FREERTOSCPP_USE_CHRONO
       /**
@@ -224,7 +254,7 @@ public:
        * @return True if an item returned.
        */
       bool pop(T& var, Time_ms time) {
-        return xQueueReceive(queueHandle, &var, ms2ticks(time));
+        return levelChanged(FREERTOSCPP_PERF_CHECK(xQueueReceive(queueHandle, &var, ms2ticks(time)), perfQueueReceiveFail));
       }
 #endif
 
@@ -261,7 +291,7 @@ public:
 	   * @return True if successful
 	   */
 	  bool push_ISR(T const& item, portBASE_TYPE& waswoken){
-	    return xQueueSendToFrontFromISR(queueHandle, &item, &waswoken);
+	    return levelChanged_ISR(FREERTOSCPP_PERF_CHECK(xQueueSendToFrontFromISR(queueHandle, &item, &waswoken), perfQueueSendFail), waswoken);
 	  }
 
 	  /**
@@ -274,7 +304,7 @@ public:
 	   * @return True if successful
 	   */
 	  bool add_ISR(T const& item, portBASE_TYPE& waswoken){
-	    return xQueueSendToBackFromISR(queueHandle, &item, &waswoken);
+	    return levelChanged_ISR(FREERTOSCPP_PERF_CHECK(xQueueSendToBackFromISR(queueHandle, &item, &waswoken), perfQueueSendFail), waswoken);
 	  }
 
 	  /**
@@ -287,7 +317,7 @@ public:
 	   * @return True if an item returned.
 	   */
 	  bool pop_ISR(T& var, portBASE_TYPE& waswoken) {
-	    return xQueueReceiveFromISR(queueHandle, &var, &waswoken);
+	    return levelChanged_ISR(xQueueReceiveFromISR(queueHandle, &var, &waswoken), waswoken);
 	  }
 
 	  /**
@@ -378,6 +408,365 @@ public:
 };
 #endif
 
+#ifndef FREERTOSCPP_SNAPSHOT_BYTES
+/**
+ * @def FREERTOSCPP_SNAPSHOT_BYTES
+ * Largest SelectiveQueue::snapshot() copy done inside a single critical section.
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_SNAPSHOT_BYTES  64
+#endif
+
+/**
+ * @brief Queue with Selective Receive.
+ *
+ * A Queue that, besides normal FIFO operation, allows a receiver to get (pop_if()) or look
+ * at (peek_if()) the first pending item that matches a predicate, leaving the other items
+ * in place and in order. For example, to wait for the ACK for a given sequence number while
+ * other messages keep arriving.
+ *
+ * Unlike Queue, the items are stored in the object itself rather than a FreeRTOS queue,
+ * so they can be scanned in place. A blocked receiver registers its predicate, and adding
+ * an item only wakes the receivers whose predicate matches that item. Blocking uses the task
+ * notification at FREERTOSCPP_NOTIFY_INDEX, so configTASK_NOTIFICATION_ARRAY_ENTRIES must be
+ * at least 2. On kernels before 10.4 that is index 0, and a receiving task must not also use
+ * TaskBase give()/take().
+ *
+ * Predicates are called inside a critical section, and for add_ISR() from the interrupt,
+ * so must be short and must not block.
+ *
+ * Example Usage:
+ * @code
+ * SelectiveQueue<Packet, 16> rxQueue;
+ *
+ * Packet ack;
+ * if(rxQueue.pop_if(ack, [seq](Packet const& p) { return p.type == Ack && p.seq == seq; }, 100)) {
+ *     ...
+ * }
+ * @endcode
+ *
+ * @tparam T The type of object to be placed on the queue, needs to be copy assignable.
+ * @tparam queueLength The number of elements to reserve space for in the queue.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned queueLength> class SelectiveQueue {
+    static_assert(queueLength > 0, "SelectiveQueue needs a length");
+#if FREERTOS_VERSION_ALL >= 10'004'000
+    // Taking the notification clears it, so sharing index 0 would swallow the task's own give()s.
+    // (sizeof(T) just makes the check wait until the template is used.)
+    static_assert(sizeof(T) && FREERTOSCPP_NOTIFY_INDEX != 0 && FREERTOSCPP_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+                  "SelectiveQueue needs configTASK_NOTIFICATION_ARRAY_ENTRIES > 1");
+#endif
+public:
+    SelectiveQueue() : head(0), count(0), sequence(0), receivers(nullptr), senders(nullptr) {}
+
+    /**
+     * @brief Push an item onto the Queue.
+     * Puts an item onto the Queue so it will be the next item to remove.
+     * @param item The item to put on the Queue.
+     * @param time How long to wait for room if Queue is full.
+     * @return True if successful
+     */
+    bool push(T const& item, TickType_t time = portMAX_DELAY) {
+        return FREERTOSCPP_PERF_CHECK(send(item, time, true), perfQueueSendFail);
+    }
+    /**
+     * @brief add an item at end of the Queue.
+     * Puts an item onto the Queue so it will be the last item to remove.
+     * @param item The item to put on the Queue.
+     * @param time How long to wait for room if Queue is full.
+     * @return True if successful
+     */
+    bool add(T const& item, TickType_t time = portMAX_DELAY) {
+        return FREERTOSCPP_PERF_CHECK(send(item, time, false), perfQueueSendFail);
+    }
+    /**
+     * @brief Get an item from the Queue.
+     * Gets the first item from the Queue
+     * @param var Variable to place the item
+     * @param time How long to wait for an item to be available.
+     * @return True if an item returned.
+     */
+    bool pop(T& var, TickType_t time = portMAX_DELAY) {
+        AnyItem any;
+        return FREERTOSCPP_PERF_CHECK(receive(var, any, time, true), perfQueueReceiveFail);
+    }
+    /**
+     * @brief Get the first matching item from the Queue.
+     * Removes the first item for which pred returns true, the other items keep their order.
+     * @param var Variable to place the item
+     * @param pred Predicate, called as pred(T const&) returning bool.
+     * @param time How long to wait for a matching item to be available.
+     * @return True if an item returned.
+     */
+    template<class Pred> bool pop_if(T& var, Pred pred, TickType_t time = portMAX_DELAY) {
+        return FREERTOSCPP_PERF_CHECK(receive(var, pred, time, true), perfQueueReceiveFail);
+    }
+    /**
+     * @brief Look at the first item in the Queue.
+     * Gets the first item from the Queue leaving it there.
+     * @param var Variable to place the item
+     * @param time How long to wait for an item to be available.
+     * @return True if an item returned.
+     */
+    bool peek(T& var, TickType_t time = 0) {
+        AnyItem any;
+        return receive(var, any, time, false);
+    }
+    /**
+     * @brief Look at the first matching item in the Queue.
+     * Gets the first item for which pred returns true, leaving it there.
+     * @param var Variable to place the item
+     * @param pred Predicate, called as pred(T const&) returning bool.
+     * @param time How long to wait for a matching item to be available.
+     * @return True if an item returned.
+     */
+    template<class Pred> bool peek_if(T& var, Pred pred, TickType_t time = 0) {
+        return receive(var, pred, time, false);
+    }
+#if FREERTOSCPP_USE_CHRONO
+    bool push(T const& item, Time_ms time) { return push(item, ms2ticks(time)); }
+    bool add(T const& item, Time_ms time) { return add(item, ms2ticks(time)); }
+    bool pop(T& var, Time_ms time) { return pop(var, ms2ticks(time)); }
+    template<class Pred> bool pop_if(T& var, Pred pred, Time_ms time) { return pop_if(var, pred, ms2ticks(time)); }
+    bool peek(T& var, Time_ms time) { return peek(var, ms2ticks(time)); }
+    template<class Pred> bool peek_if(T& var, Pred pred, Time_ms time) { return peek_if(var, pred, ms2ticks(time)); }
+#endif
+
+    /**
+     * @brief add an item at end of the Queue.
+     * Puts an item onto the Queue so it will be the last item to remove.
+     *
+     * Note: Interrupt service routines should only call _ISR routines.
+     * @param item The item to put on the Queue.
+     * @param waswoken Flag variable to determine if context switch is needed.
+     * @return True if successful
+     */
+    bool add_ISR(T const& item, portBASE_TYPE& waswoken) {
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        bool ok = count < queueLength;
+        if(ok) {
+            store[index(count)] = item;
+            count++;
+            sequence++;
+            for(Waiter* w = receivers; w; w = w->next) {
+                if(w->match(w->pred, item)) notifyGive_ISR(w->task, waswoken);
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        return FREERTOSCPP_PERF_CHECK(ok, perfQueueSendFail);
+    }
+
+    /**
+     * @brief Get the number of items in the Queue.
+     */
+    unsigned waiting() const { return count; }
+    /**
+     * @brief Get the number of free spaces in the Queue.
+     */
+    unsigned available() const { return queueLength - count; }
+
+    /**
+     * @brief Look at every pending item, without removing any.
+     *
+     * Calls fn(T const&) for each item, in order, inside one critical section, so fn
+     * must be short and must not block. For longer processing, use snapshot().
+     * @param fn The function to call.
+     */
+    template<class Fn> void forEachPending(Fn fn) const {
+        taskENTER_CRITICAL();
+        for(unsigned i = 0; i < count; i++) {
+            fn(static_cast<T const&>(store[index(i)]));
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    /**
+     * @brief Copy the pending items, without removing any.
+     *
+     * Small copies (up to FREERTOSCPP_SNAPSHOT_BYTES) are done in one critical section.
+     * Larger ones are copied with interrupts enabled, and retried if the Queue changed
+     * during the copy, falling back to a critical section if it keeps changing.
+     *
+     * The unlocked copy may read an item while it is being written, which is only harmless
+     * when the copy is a plain copy of bytes that is thrown away, so it is only done for
+     * trivially copyable T. Other types are always copied in a critical section.
+     * @param out Where to copy the items to, oldest first.
+     * @param max The most items to copy.
+     * @return The number of items copied.
+     */
+    unsigned snapshot(T* out, unsigned max) const {
+        for(int tries = 0; tries < 3; tries++) {
+            taskENTER_CRITICAL();
+            uint32_t seq = sequence;
+            unsigned n = count < max ? count : max;
+            if(!std::is_trivially_copyable<T>::value || n * sizeof(T) <= FREERTOSCPP_SNAPSHOT_BYTES) {
+                copyOut(out, head, n);
+                taskEXIT_CRITICAL();
+                return n;
+            }
+            unsigned first = head;
+            taskEXIT_CRITICAL();
+
+            copyOut(out, first, n);
+
+            taskENTER_CRITICAL();
+            bool same = seq == sequence;
+            taskEXIT_CRITICAL();
+            if(same) return n;
+        }
+        taskENTER_CRITICAL();
+        unsigned n = count < max ? count : max;
+        copyOut(out, head, n);
+        taskEXIT_CRITICAL();
+        return n;
+    }
+
+private:
+    /// A task blocked on the Queue, on the stack of that task.
+    struct Waiter {
+        TaskHandle_t    task;
+        bool          (*match)(void* pred, T const& item);  ///< Predicate thunk, receivers only
+        void*           pred;
+        Waiter*         next;
+    };
+
+    /// Predicate for the plain pop()/peek().
+    struct AnyItem {
+        bool operator()(T const&) const { return true; }
+    };
+
+    template<class Pred> static bool matchThunk(void* pred, T const& item) {
+        return (*static_cast<Pred*>(pred))(item);
+    }
+
+    unsigned index(unsigned i) const { return (head + i) % queueLength; }
+
+    void copyOut(T* out, unsigned first, unsigned n) const {
+        for(unsigned i = 0; i < n; i++) {
+            out[i] = store[(first + i) % queueLength];
+        }
+    }
+
+    static void link(Waiter*& list, Waiter& w) {
+        w.next = list;
+        list = &w;
+    }
+    static void unlink(Waiter*& list, Waiter& w) {
+        for(Waiter** ptr = &list; *ptr; ptr = &(*ptr)->next) {
+            if(*ptr == &w) {
+                *ptr = w.next;
+                break;
+            }
+        }
+    }
+
+    static void notifyGive(TaskHandle_t task) {
+#if FREERTOS_VERSION_ALL >= 10'004'000
+        xTaskNotifyGiveIndexed(task, FREERTOSCPP_NOTIFY_INDEX);
+#else
+        xTaskNotifyGive(task);
+#endif
+    }
+    static void notifyGive_ISR(TaskHandle_t task, portBASE_TYPE& waswoken) {
+#if FREERTOS_VERSION_ALL >= 10'004'000
+        vTaskNotifyGiveIndexedFromISR(task, FREERTOSCPP_NOTIFY_INDEX, &waswoken);
+#else
+        vTaskNotifyGiveFromISR(task, &waswoken);
+#endif
+    }
+    static void notifyTake(TickType_t time) {
+#if FREERTOS_VERSION_ALL >= 10'004'000
+        ulTaskNotifyTakeIndexed(FREERTOSCPP_NOTIFY_INDEX, pdTRUE, time);
+#else
+        ulTaskNotifyTake(pdTRUE, time);
+#endif
+    }
+
+    /**
+     * Block the current task on list until notified or timed out.
+     * Called in a critical section, which is exited and reentered.
+     * @return false if timed out.
+     */
+    bool block(Waiter*& list, Waiter& w, TimeOut_t& timeout, TickType_t& time) {
+        if(time == 0 || xTaskCheckForTimeOut(&timeout, &time)) return false;
+        link(list, w);
+        taskEXIT_CRITICAL();
+        notifyTake(time);
+        taskENTER_CRITICAL();
+        unlink(list, w);
+        return true;
+    }
+
+    bool send(T const& item, TickType_t time, bool front) {
+        Waiter w = { xTaskGetCurrentTaskHandle(), nullptr, nullptr, nullptr };
+        TimeOut_t timeout;
+        vTaskSetTimeOutState(&timeout);
+        taskENTER_CRITICAL();
+        while(count >= queueLength) {
+            if(!block(senders, w, timeout, time)) {
+                taskEXIT_CRITICAL();
+                return false;
+            }
+        }
+        if(front) {
+            head = (head + queueLength - 1) % queueLength;
+            store[head] = item;
+        } else {
+            store[index(count)] = item;
+        }
+        count++;
+        sequence++;
+        for(Waiter* r = receivers; r; r = r->next) {
+            if(r->match(r->pred, item)) notifyGive(r->task);
+        }
+        taskEXIT_CRITICAL();
+        return true;
+    }
+
+    template<class Pred> bool receive(T& var, Pred& pred, TickType_t time, bool remove) {
+        Waiter w = { xTaskGetCurrentTaskHandle(), &matchThunk<Pred>, &pred, nullptr };
+        TimeOut_t timeout;
+        vTaskSetTimeOutState(&timeout);
+        taskENTER_CRITICAL();
+        do {
+            for(unsigned i = 0; i < count; i++) {
+                if(pred(static_cast<T const&>(store[index(i)]))) {
+                    var = store[index(i)];
+                    if(remove) {
+                        // Close the gap, keeping the order of the rest.
+                        for(unsigned j = i + 1; j < count; j++) {
+                            store[index(j - 1)] = store[index(j)];
+                        }
+                        count--;
+                        sequence++;
+                        for(Waiter* s = senders; s; s = s->next) notifyGive(s->task);
+                    }
+                    taskEXIT_CRITICAL();
+                    return true;
+                }
+            }
+        } while(block(receivers, w, timeout, time));
+        taskEXIT_CRITICAL();
+        return false;
+    }
+
+    unsigned    head;           ///< Index of the first item.
+    unsigned    count;          ///< Number of items in the Queue.
+    uint32_t    sequence;       ///< Changed by every add and remove, for snapshot().
+    Waiter*     receivers;      ///< Tasks blocked in pop/peek
+    Waiter*     senders;        ///< Tasks blocked waiting for room
+    T           store[queueLength];
+
+#if __cplusplus < 201101L
+    SelectiveQueue(SelectiveQueue const&);      ///< We are not copyable.
+    void operator =(SelectiveQueue const&);  ///< We are not assignable.
+#else
+    SelectiveQueue(SelectiveQueue const&) = delete;      ///< We are not copyable.
+    void operator =(SelectiveQueue const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
 #if FREERTOSCPP_USE_NAMESPACE
 }   // namespace FreeRTOScpp
 #endif
@@ -0,0 +1,222 @@
+/**
+ * @file RateLimiter.h
+ * @brief Token Bucket Rate Limiter
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_RATELIMITER_H_
+#define FREERTOSPP_RATELIMITER_H_
+
+#include "FreeRTOScpp.h"
+#include "MutexCPP.h"
+#include "task.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Token Bucket Rate Limiter.
+ *
+ * Allows tokensPerPeriod tokens to be acquired every periodTicks ticks, with up to burst
+ * tokens being saved up for use at once.
+ *
+ * No timer is used, the bucket is refilled lazily from xTaskGetTickCount() when it is
+ * looked at. Internally the credit is kept in units of 1/periodTicks of a token, so
+ * each tick adds exactly tokensPerPeriod units, and there is no rounding drift.
+ *
+ * A Mutex is used as a turnstile so the limiter can be shared by several tasks. The
+ * task that holds the Mutex is the next to be served, and sleeps for exactly the number
+ * of ticks needed for its tokens to build up. The other tasks wait on the Mutex, and so
+ * are served in priority order, and first come first served within a priority. A
+ * tryAcquire() will not jump ahead of a task already waiting in acquire().
+ *
+ * The limiter is not usable from an ISR.
+ *
+ * Example Usage:
+ * @code
+ * RateLimiter logLimit(10, 1000, 20);     // 10 messages a second, bursts of up to 20
+ *
+ * // In some task
+ * if(logLimit.tryAcquire()) {
+ *    ... // output the message
+ * } else {
+ *    dropped++;
+ * }
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class RateLimiter {
+public:
+    /**
+     * @brief Constructor
+     *
+     * tokensPerPeriod_ and periodTicks_ must be non-zero, and burst * periodTicks must fit in 32 bits.
+     *
+     * @param tokensPerPeriod_ Number of tokens added each period.
+     * @param periodTicks_ Length of the period in ticks.
+     * @param burst_ Maximum number of tokens that can be saved up, defaults to tokensPerPeriod_.
+     * @param name Name for the turnstile Mutex, used for the Debug Registry if setup.
+     */
+    RateLimiter(uint32_t tokensPerPeriod_, TickType_t periodTicks_, uint32_t burst_ = 0, char const* name = "RateLimiter") :
+        turnstile(name),
+        rate(tokensPerPeriod_ ? tokensPerPeriod_ : 1),
+        period(periodTicks_ ? periodTicks_ : 1),
+        burst(burst_ ? burst_ : tokensPerPeriod_),
+        capacity(burst * period),
+        credit(capacity),
+        lastTick(xTaskGetTickCount())
+    {
+        configASSERT(tokensPerPeriod_ != 0);
+        configASSERT(periodTicks_ != 0);
+    }
+
+    /**
+     * @brief Acquire tokens, waiting for them if needed.
+     *
+     * If it is not possible for the tokens to build up within the timeout, we return
+     * right away without waiting.
+     *
+     * @param n Number of tokens to acquire.
+     * @param wait Maximum number of ticks to wait.
+     * @return true if the tokens were acquired.
+     */
+    bool acquire(uint32_t n = 1, TickType_t wait = portMAX_DELAY) {
+        if(n > burst) return false;     // Can never be satisfied
+        TickType_t start = xTaskGetTickCount();
+        if(!turnstile.take(wait)) return false;
+        while(1) {
+            refill();
+            uint32_t needed = n * period;
+            if(credit >= needed) {
+                credit -= needed;
+                turnstile.give();
+                return true;
+            }
+            TickType_t delay = (needed - credit + rate - 1) / rate;
+            if(wait != portMAX_DELAY) {
+                TickType_t used = xTaskGetTickCount() - start;
+                if(used > wait || delay > wait - used) break;
+            }
+            vTaskDelay(delay);
+        }
+        turnstile.give();
+        return false;
+    }
+
+#if FREERTOSCPP_USE_CHRONO
+    /**
+     * @brief Acquire tokens, waiting for them if needed.
+     *
+     * @param n Number of tokens to acquire.
+     * @param wait Maximum time to wait.
+     * @return true if the tokens were acquired.
+     */
+    bool acquire(uint32_t n, Time_ms wait) {
+        return acquire(n, ms2ticks(wait));
+    }
+#endif
+
+    /**
+     * @brief Acquire tokens only if they are available now.
+     *
+     * Fails if another task is waiting in acquire(), so it can't be starved.
+     *
+     * @param n Number of tokens to acquire.
+     * @return true if the tokens were acquired.
+     */
+    bool tryAcquire(uint32_t n = 1) {
+        if(n > burst) return false;
+        if(!turnstile.take(0)) return false;
+        refill();
+        bool ok = credit >= n * period;
+        if(ok) credit -= n * period;
+        turnstile.give();
+        return ok;
+    }
+
+    /**
+     * @brief Number of whole tokens currently available.
+     *
+     * Only a hint, as other tasks may take tokens right after this.
+     */
+    uint32_t available() {
+        uint32_t tokens = 0;
+        if(turnstile.take(0)) {
+            refill();
+            tokens = credit / period;
+            turnstile.give();
+        }
+        return tokens;
+    }
+
+private:
+    /**
+     * @brief Add the credit for the ticks since the last refill.
+     *
+     * Must be called with the turnstile held.
+     */
+    void refill() {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t elapsed = now - lastTick;
+        lastTick = now;
+        uint32_t room = capacity - credit;
+        // Check against room/rate first so the multiply can't overflow.
+        if(elapsed >= (room + rate - 1) / rate) {
+            credit = capacity;
+        } else {
+            credit += elapsed * rate;
+        }
+    }
+
+    Mutex       turnstile;
+    uint32_t    rate;       ///< Credit added per tick (tokensPerPeriod)
+    TickType_t  period;     ///< Credit for one token (periodTicks)
+    uint32_t    burst;      ///< Maximum tokens saved up
+    uint32_t    capacity;   ///< Maximum credit, burst * period
+    uint32_t    credit;
+    TickType_t  lastTick;
+
+#if __cplusplus < 201101L
+    RateLimiter(RateLimiter const&);      ///< We are not copyable.
+    void operator =(RateLimiter const&);  ///< We are not assignable.
+#else
+    RateLimiter(RateLimiter const&) = delete;      ///< We are not copyable.
+    void operator =(RateLimiter const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_RATELIMITER_H_ */
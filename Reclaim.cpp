@@ -0,0 +1,290 @@
+/**
+ * @file Reclaim.cpp
+ * @brief Safe Memory Reclamation for Lock-Free Structures
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "Reclaim.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0
+
+ReclaimDomain::ReclaimDomain(ReclaimerBase* reclaimer_, BaseType_t tlsIndex_) :
+retired(nullptr),
+pendingCount(0),
+reclaimedCount(0),
+reclaimer(reclaimer_),
+tlsIndex(tlsIndex_),
+link(nullptr)
+{
+    if(reclaimer) {
+        taskENTER_CRITICAL();
+        link = reclaimer->domains;
+        reclaimer->domains = this;
+        reclaimer->listVersion++;
+        taskEXIT_CRITICAL();
+    }
+}
+
+ReclaimDomain::~ReclaimDomain() {
+    unregister();
+}
+
+void ReclaimDomain::unregister() {
+    if(!reclaimer) return;
+    taskENTER_CRITICAL();
+    ReclaimDomain** ptr = &reclaimer->domains;
+    while(*ptr) {
+        if(*ptr == this) {
+            *ptr = link;
+            break;
+        }
+        ptr = &(*ptr)->link;
+    }
+    reclaimer->listVersion++;
+    // If the Reclaimer is collecting us right now, wait for it to finish.
+    while(reclaimer->active == this) {
+        taskEXIT_CRITICAL();
+        vTaskDelay(1);
+        taskENTER_CRITICAL();
+    }
+    reclaimer = nullptr;
+    taskEXIT_CRITICAL();
+}
+
+void ReclaimDomain::push(Reclaimable* node) {
+    Reclaimable* head = retired.load(std::memory_order_relaxed);
+    do {
+        node->retiredNext = head;
+    } while(!retired.compare_exchange_weak(head, node));
+    unsigned waiting = pendingCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    if(reclaimer && waiting == reclaimer->batch) reclaimer->wake();
+}
+
+void ReclaimDomain::requeue(Reclaimable* head, Reclaimable* tail) {
+    Reclaimable* old = retired.load(std::memory_order_relaxed);
+    do {
+        tail->retiredNext = old;
+    } while(!retired.compare_exchange_weak(old, head));
+}
+
+void ReclaimDomain::release(Reclaimable* node) {
+    pendingCount.fetch_sub(1, std::memory_order_relaxed);
+    reclaimedCount++;
+    node->reclaim();
+}
+
+HazardDomainBase::HazardDomainBase(HazardRecord* records_, unsigned count_, ReclaimerBase* reclaimer_, BaseType_t tlsIndex_) :
+ReclaimDomain(reclaimer_, tlsIndex_),
+records(records_),
+count(count_)
+{
+    for(unsigned i = 0; i < count; ++i) {
+        records[i].owner.store(nullptr, std::memory_order_relaxed);
+        for(unsigned j = 0; j < FREERTOSCPP_HAZARD_SLOTS; ++j) {
+            records[i].hazard[j].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+}
+
+HazardRecord* HazardDomainBase::record() {
+    HazardRecord* rec = taskRecord();
+    if(rec) return rec;
+    TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    for(unsigned i = 0; i < count; ++i) {
+        TaskHandle_t expected = nullptr;
+        if(records[i].owner.compare_exchange_strong(expected, me)) {
+            tlsRecord(&records[i]);
+            return &records[i];
+        }
+    }
+    configASSERT(0);    // More tasks than records
+    return nullptr;
+}
+
+void HazardDomainBase::detach() {
+    HazardRecord* rec = taskRecord();
+    if(!rec) return;
+    for(unsigned j = 0; j < FREERTOSCPP_HAZARD_SLOTS; ++j) {
+        rec->hazard[j].store(nullptr, std::memory_order_relaxed);
+    }
+    tlsRecord(nullptr);
+    rec->owner.store(nullptr, std::memory_order_release);
+}
+
+bool HazardDomainBase::isProtected(Reclaimable* node) const {
+    for(unsigned i = 0; i < count; ++i) {
+        if(!records[i].owner.load()) continue;
+        for(unsigned j = 0; j < FREERTOSCPP_HAZARD_SLOTS; ++j) {
+            if(records[i].hazard[j].load() == node) return true;
+        }
+    }
+    return false;
+}
+
+void HazardDomainBase::collect() {
+    Reclaimable* node = takeRetired();
+    Reclaimable* keepHead = nullptr;
+    Reclaimable* keepTail = nullptr;
+    while(node) {
+        Reclaimable* following = next(node);
+        if(isProtected(node)) {
+            next(node, keepHead);
+            keepHead = node;
+            if(!keepTail) keepTail = node;
+        } else {
+            release(node);
+        }
+        node = following;
+    }
+    if(keepHead) requeue(keepHead, keepTail);
+}
+
+EpochDomainBase::EpochDomainBase(EpochRecord* records_, unsigned count_, ReclaimerBase* reclaimer_, BaseType_t tlsIndex_) :
+ReclaimDomain(reclaimer_, tlsIndex_),
+records(records_),
+count(count_),
+globalEpoch(0)
+{
+    for(unsigned i = 0; i < count; ++i) {
+        records[i].owner.store(nullptr, std::memory_order_relaxed);
+        records[i].announce.store(0, std::memory_order_relaxed);
+        records[i].nest = 0;
+    }
+}
+
+EpochRecord* EpochDomainBase::record() {
+    EpochRecord* rec = taskRecord();
+    if(rec) return rec;
+    TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    for(unsigned i = 0; i < count; ++i) {
+        TaskHandle_t expected = nullptr;
+        if(records[i].owner.compare_exchange_strong(expected, me)) {
+            tlsRecord(&records[i]);
+            return &records[i];
+        }
+    }
+    configASSERT(0);    // More tasks than records
+    return nullptr;
+}
+
+void EpochDomainBase::enter() {
+    EpochRecord* rec = record();
+    if(rec->nest++ > 0) return;
+    // Announce, and make sure the epoch didn't move before the announcement was visible.
+    uint32_t epoch;
+    do {
+        epoch = globalEpoch.load();
+        rec->announce.store((epoch << 1) | 1);
+    } while(globalEpoch.load() != epoch);
+}
+
+void EpochDomainBase::exit() {
+    EpochRecord* rec = taskRecord();
+    configASSERT(rec && rec->nest > 0);
+    if(--rec->nest == 0) {
+        rec->announce.store(0, std::memory_order_release);
+    }
+}
+
+void EpochDomainBase::detach() {
+    EpochRecord* rec = taskRecord();
+    if(!rec) return;
+    configASSERT(rec->nest == 0);
+    tlsRecord(nullptr);
+    rec->owner.store(nullptr, std::memory_order_release);
+}
+
+void EpochDomainBase::collect() {
+    // Only the collector moves the epoch, once every reader in a section is in the current one.
+    uint32_t epoch = globalEpoch.load();
+    bool advance = true;
+    for(unsigned i = 0; i < count && advance; ++i) {
+        if(!records[i].owner.load()) continue;
+        uint32_t announce = records[i].announce.load();
+        if(announce && (announce >> 1) != (epoch & 0x7FFFFFFF)) advance = false;
+    }
+    if(advance) {
+        epoch++;
+        globalEpoch.store(epoch);
+    }
+
+    // A node retired in epoch e may be seen by readers in e and e+1.
+    Reclaimable* node = takeRetired();
+    Reclaimable* keepHead = nullptr;
+    Reclaimable* keepTail = nullptr;
+    while(node) {
+        Reclaimable* following = next(node);
+        if(static_cast<uint32_t>(epoch - node->retiredEpoch) < 2) {
+            next(node, keepHead);
+            keepHead = node;
+            if(!keepTail) keepTail = node;
+        } else {
+            release(node);
+        }
+        node = following;
+    }
+    if(keepHead) requeue(keepHead, keepTail);
+}
+
+void ReclaimerBase::collect() {
+    // Domains are removed by other tasks, and collecting frees nodes, so can't be done in a
+    // critical section. Walk the list locked, letting go to collect each domain, which is
+    // marked active so its destructor waits for us.
+    taskENTER_CRITICAL();
+    uint32_t version = listVersion;
+    ReclaimDomain* domain = domains;
+    while(domain) {
+        active = domain;
+        taskEXIT_CRITICAL();
+        domain->collect();
+        taskENTER_CRITICAL();
+        active = nullptr;
+        if(version != listVersion) {
+            // The list changed while unlocked, so domain may be gone. Start over, collecting
+            // a domain again just finds less to free.
+            version = listVersion;
+            domain = domains;
+            continue;
+        }
+        domain = domain->link;
+    }
+    taskEXIT_CRITICAL();
+}
+
+#endif // configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
@@ -0,0 +1,495 @@
+/**
+ * @file Reclaim.h
+ * @brief Safe Memory Reclamation for Lock-Free Structures
+ *
+ * A node removed from a lock-free structure can't be freed while another task may still
+ * be reading it, and with preemption that task can be stopped at any point. Two schemes
+ * are provided to decide when a retired node is safe to free:
+ * + HazardDomain: readers publish the pointers they are using in hazard slots.
+ * + EpochDomain: readers mark when they are inside a read section, and nodes are freed
+ *   once every reader has moved past the epoch they were retired in.
+ *
+ * Retired nodes are freed in batches by a low priority Reclaimer task.
+ *
+ * Each task's record in a domain is found through a FreeRTOS thread local storage pointer,
+ * so needs configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_RECLAIM_H_
+#define FREERTOSPP_RECLAIM_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+#include <atomic>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0
+
+#ifndef FREERTOSCPP_RECLAIM_TLS_INDEX
+/**
+ * @def FREERTOSCPP_RECLAIM_TLS_INDEX
+ * Default thread local storage index a reclamation domain keeps a task's record in.
+ * Each domain a task uses needs its own index.
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_RECLAIM_TLS_INDEX   0
+#endif
+
+#ifndef FREERTOSCPP_HAZARD_SLOTS
+/**
+ * @def FREERTOSCPP_HAZARD_SLOTS
+ * Number of hazard pointers each task has in a HazardDomain.
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_HAZARD_SLOTS    2
+#endif
+
+class ReclaimDomain;
+class ReclaimerBase;
+
+/**
+ * @brief Base for nodes that can be retired to a reclamation domain.
+ *
+ * reclaim() is called when the node is safe to free, by default deleting it. Override it
+ * to return the node to a pool instead.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class Reclaimable {
+    friend class ReclaimDomain;
+    friend class HazardDomainBase;
+    friend class EpochDomainBase;
+public:
+    Reclaimable() : retiredNext(nullptr), retiredEpoch(0) {}
+    virtual ~Reclaimable() {}
+    /**
+     * @brief Free the node, called by the Reclaimer once no task can be using it.
+     */
+    virtual void reclaim() { delete this; }
+private:
+    Reclaimable*    retiredNext;
+    uint32_t        retiredEpoch;
+};
+
+/**
+ * @brief Common base of the reclamation domains.
+ *
+ * Holds the list of retired nodes waiting to be freed. Retiring is lock-free, and usable
+ * from any task. collect() is called by the Reclaimer the domain is registered with (or
+ * by the application, if none), and must only be called from one task.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class ReclaimDomain {
+    friend class ReclaimerBase;
+public:
+    /**
+     * @brief Free the retired nodes that are now safe.
+     */
+    virtual void collect() = 0;
+    /**
+     * @brief Number of retired nodes not yet freed.
+     */
+    unsigned pending() const { return pendingCount.load(std::memory_order_relaxed); }
+    /**
+     * @brief Number of nodes freed.
+     */
+    uint32_t reclaimed() const { return reclaimedCount; }
+
+protected:
+    /**
+     * @brief Constructor
+     * @param reclaimer_ The Reclaimer to free our nodes, or nullptr to call collect() directly.
+     * @param tlsIndex_ The thread local storage index for the task records.
+     */
+    ReclaimDomain(ReclaimerBase* reclaimer_, BaseType_t tlsIndex_);
+    virtual ~ReclaimDomain();
+    /**
+     * @brief Take the domain off its Reclaimer, waiting for a collect() in progress to finish.
+     *
+     * Called first thing by the destructor of the class implementing collect(), while that
+     * is still usable. So a domain must not be destroyed by the Reclaimer's own task.
+     */
+    void unregister();
+
+    /// Add a node to the retired list.
+    void push(Reclaimable* node);
+    /// Take the whole retired list.
+    Reclaimable* takeRetired() { return retired.exchange(nullptr); }
+    /// Put back a list of nodes still not safe to free.
+    void requeue(Reclaimable* head, Reclaimable* tail);
+    /// Free a node taken from the retired list.
+    void release(Reclaimable* node);
+
+    void*   tlsRecord() const { return pvTaskGetThreadLocalStoragePointer(nullptr, tlsIndex); }
+    void    tlsRecord(void* record) { vTaskSetThreadLocalStoragePointer(nullptr, tlsIndex, record); }
+
+    static Reclaimable* next(Reclaimable* node) { return node->retiredNext; }
+    static void         next(Reclaimable* node, Reclaimable* next_) { node->retiredNext = next_; }
+
+private:
+    std::atomic<Reclaimable*>   retired;
+    std::atomic<unsigned>       pendingCount;
+    uint32_t                    reclaimedCount;
+    ReclaimerBase*              reclaimer;
+    BaseType_t                  tlsIndex;
+    ReclaimDomain*              link;
+
+#if __cplusplus < 201101L
+    ReclaimDomain(ReclaimDomain const&);      ///< We are not copyable.
+    void operator =(ReclaimDomain const&);  ///< We are not assignable.
+#else
+    ReclaimDomain(ReclaimDomain const&) = delete;      ///< We are not copyable.
+    void operator =(ReclaimDomain const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief A task's hazard pointers.
+ * @ingroup FreeRTOSCpp
+ */
+struct HazardRecord {
+    std::atomic<TaskHandle_t>   owner;
+    std::atomic<Reclaimable*>   hazard[FREERTOSCPP_HAZARD_SLOTS];
+};
+
+/**
+ * @brief Hazard Pointer Reclamation.
+ *
+ * Before dereferencing a shared pointer, a reader protect()s it in one of its hazard slots,
+ * and clear()s the slot when done. A retired node is only freed when no slot holds it, so
+ * a reader preempted for any length of time only holds back the nodes it has protected.
+ *
+ * Each task gets a record the first time it uses the domain, and should detach() before
+ * it is deleted to return the record.
+ *
+ * Example Usage:
+ * @code
+ * struct Node : Reclaimable { int value; std::atomic<Node*> next; };
+ * HazardDomain<8> hazards(&reclaimer);
+ *
+ * // Reader
+ * Node* node = hazards.protect(0, head);
+ * if(node) use(node->value);
+ * hazards.clear(0);
+ *
+ * // Writer, after unlinking old
+ * hazards.retire(old);
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class HazardDomainBase : public ReclaimDomain {
+protected:
+    HazardDomainBase(HazardRecord* records_, unsigned count_, ReclaimerBase* reclaimer_, BaseType_t tlsIndex_);
+    ~HazardDomainBase() { unregister(); }
+
+public:
+    /**
+     * @brief Protect the pointer in src.
+     *
+     * Publishes the pointer in a hazard slot, and rereads src until it is stable, so the
+     * node can't have been retired before it was protected.
+     *
+     * @param slot The hazard slot to use, 0 to FREERTOSCPP_HAZARD_SLOTS-1.
+     * @param src The shared pointer to read.
+     * @return The protected pointer, which stays valid until the slot is cleared or reused.
+     */
+    template<class T> T* protect(unsigned slot, std::atomic<T*> const& src) {
+        std::atomic<Reclaimable*>& hazard = record()->hazard[slot];
+        T* ptr = src.load();
+        while(1) {
+            hazard.store(ptr);
+            T* again = src.load();
+            if(again == ptr) return ptr;
+            ptr = again;
+        }
+    }
+    /**
+     * @brief Clear a hazard slot.
+     */
+    void clear(unsigned slot) { record()->hazard[slot].store(nullptr, std::memory_order_release); }
+    /**
+     * @brief Retire a node that has been unlinked from the structure.
+     */
+    void retire(Reclaimable* node) { push(node); }
+    /**
+     * @brief Return the calling task's record, clearing its hazards.
+     */
+    void detach();
+
+    void collect() override;
+
+private:
+    /// The calling task's record, claimed on first use.
+    HazardRecord* record();
+    /// The calling task's record if it has one. Checked to be one of ours, as a domain
+    /// wrongly sharing our TLS index would leave its own record there.
+    HazardRecord* taskRecord() const {
+        HazardRecord* rec = static_cast<HazardRecord*>(tlsRecord());
+        configASSERT(!rec || (rec >= records && rec < records + count));
+        return rec;
+    }
+    bool isProtected(Reclaimable* node) const;
+
+    HazardRecord*   records;
+    unsigned        count;
+};
+
+/**
+ * @brief Hazard Pointer Reclamation.
+ * @tparam maxTasks The most tasks that can use the domain at once.
+ * @ingroup FreeRTOSCpp
+ */
+template<unsigned maxTasks> class HazardDomain : public HazardDomainBase {
+public:
+    /**
+     * @brief Constructor
+     * @param reclaimer_ The Reclaimer to free our nodes, or nullptr to call collect() directly.
+     * @param tlsIndex_ The thread local storage index for the task records.
+     */
+    HazardDomain(ReclaimerBase* reclaimer_, BaseType_t tlsIndex_ = FREERTOSCPP_RECLAIM_TLS_INDEX) :
+        HazardDomainBase(storage, maxTasks, reclaimer_, tlsIndex_)
+    {}
+private:
+    HazardRecord    storage[maxTasks];
+};
+
+/**
+ * @brief A task's epoch announcement.
+ * @ingroup FreeRTOSCpp
+ */
+struct EpochRecord {
+    std::atomic<TaskHandle_t>   owner;
+    std::atomic<uint32_t>       announce;   ///< Epoch entered in (shifted up, with bit 0 set), 0 when outside.
+    unsigned                    nest;       ///< Only used by the owner.
+};
+
+/**
+ * @brief Epoch Based Reclamation.
+ *
+ * Readers enter() before reading the structure, and exit() after (or use an EpochGuard).
+ * The collector advances the global epoch when every reader inside a section has seen the
+ * current one, and frees nodes retired two epochs before.
+ *
+ * Cheaper for readers than hazard pointers (one store per section rather than per
+ * pointer), but a reader preempted inside a section holds back all reclamation until it
+ * exits, so sections should be short.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class EpochDomainBase : public ReclaimDomain {
+protected:
+    EpochDomainBase(EpochRecord* records_, unsigned count_, ReclaimerBase* reclaimer_, BaseType_t tlsIndex_);
+    ~EpochDomainBase() { unregister(); }
+
+public:
+    /**
+     * @brief Enter a read section. Sections may nest.
+     */
+    void enter();
+    /**
+     * @brief Exit a read section.
+     */
+    void exit();
+    /**
+     * @brief Retire a node that has been unlinked from the structure.
+     */
+    void retire(Reclaimable* node) {
+        node->retiredEpoch = globalEpoch.load();
+        push(node);
+    }
+    /**
+     * @brief Return the calling task's record. Must be outside any section.
+     */
+    void detach();
+    /**
+     * @brief The current global epoch.
+     */
+    uint32_t epoch() const { return globalEpoch.load(std::memory_order_relaxed); }
+
+    void collect() override;
+
+private:
+    /// The calling task's record, claimed on first use.
+    EpochRecord* record();
+    /// The calling task's record if it has one, checked as for HazardDomainBase.
+    EpochRecord* taskRecord() const {
+        EpochRecord* rec = static_cast<EpochRecord*>(tlsRecord());
+        configASSERT(!rec || (rec >= records && rec < records + count));
+        return rec;
+    }
+
+    EpochRecord*            records;
+    unsigned                count;
+    std::atomic<uint32_t>   globalEpoch;
+};
+
+/**
+ * @brief Epoch Based Reclamation.
+ * @tparam maxTasks The most tasks that can use the domain at once.
+ * @ingroup FreeRTOSCpp
+ */
+template<unsigned maxTasks> class EpochDomain : public EpochDomainBase {
+public:
+    /**
+     * @brief Constructor
+     * @param reclaimer_ The Reclaimer to free our nodes, or nullptr to call collect() directly.
+     * @param tlsIndex_ The thread local storage index for the task records.
+     */
+    EpochDomain(ReclaimerBase* reclaimer_, BaseType_t tlsIndex_ = FREERTOSCPP_RECLAIM_TLS_INDEX) :
+        EpochDomainBase(storage, maxTasks, reclaimer_, tlsIndex_)
+    {}
+private:
+    EpochRecord     storage[maxTasks];
+};
+
+/**
+ * @brief Scoped Epoch read section.
+ * @ingroup FreeRTOSCpp
+ */
+class EpochGuard {
+public:
+    EpochGuard(EpochDomainBase& domain_) : domain(domain_) { domain.enter(); }
+    ~EpochGuard() { domain.exit(); }
+private:
+    EpochDomainBase&    domain;
+
+#if __cplusplus < 201101L
+    EpochGuard(EpochGuard const&);      ///< We are not copyable.
+    void operator =(EpochGuard const&);  ///< We are not assignable.
+#else
+    EpochGuard(EpochGuard const&) = delete;      ///< We are not copyable.
+    void operator =(EpochGuard const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Collects the domains registered with it.
+ * @ingroup FreeRTOSCpp
+ */
+class ReclaimerBase {
+    friend class ReclaimDomain;
+public:
+    /**
+     * @brief Constructor
+     * @param batch_ Number of retired nodes in a domain that wakes the reclaimer early.
+     */
+    ReclaimerBase(unsigned batch_) : domains(nullptr), active(nullptr), listVersion(0), batch(batch_ ? batch_ : 1) {}
+    virtual ~ReclaimerBase() {}
+
+    /**
+     * @brief Collect all the registered domains.
+     */
+    void collect();
+
+protected:
+    /// Wake the reclaimer, a domain has a batch waiting.
+    virtual void wake() = 0;
+
+private:
+    ReclaimDomain*  domains;
+    ReclaimDomain* volatile active;     ///< Domain being collected, outside the critical section.
+    uint32_t        listVersion;        ///< Bumped on each change to domains, so collect() knows to start over.
+    unsigned        batch;
+
+#if __cplusplus < 201101L
+    ReclaimerBase(ReclaimerBase const&);      ///< We are not copyable.
+    void operator =(ReclaimerBase const&);  ///< We are not assignable.
+#else
+    ReclaimerBase(ReclaimerBase const&) = delete;      ///< We are not copyable.
+    void operator =(ReclaimerBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Reclaimer Task.
+ *
+ * Frees retired nodes every period, or sooner when a domain has a batch waiting. Normally
+ * run at a low priority, so freeing doesn't delay the tasks using the structures.
+ *
+ * Example Usage:
+ * @code
+ * Reclaimer<200> reclaimer("Reclaim", TaskPrio_Low, pdMS_TO_TICKS(100), 16);
+ * EpochDomain<6> epochs(&reclaimer);
+ * @endcode
+ *
+ * @tparam stackDepth Size of the stack to give to the task
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth>
+class Reclaimer : public TaskClassS<stackDepth>, public ReclaimerBase {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority of the task.
+     * @param period_ How often to collect, in ticks.
+     * @param batch_ Number of retired nodes in a domain that wakes the reclaimer early.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    Reclaimer(char const* name, TaskPriority priority_, TickType_t period_, unsigned batch_ = 16, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_),
+        ReclaimerBase(batch_),
+        period(period_)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    void task() override {
+        while(1) {
+            TaskBase::take(true, period);
+            collect();
+        }
+    }
+
+protected:
+    void wake() override { this->give(); }
+
+private:
+    TickType_t  period;
+};
+
+#endif // configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_RECLAIM_H_ */
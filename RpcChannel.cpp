@@ -0,0 +1,118 @@
+/**
+ * @file RpcChannel.cpp
+ * @brief Request/Reply Channel with Priority Donation
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "RpcChannel.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if INCLUDE_vTaskPrioritySet && INCLUDE_uxTaskPriorityGet
+
+RpcServer::RpcServer(TaskBase& task_) :
+server(task_),
+base(task_.priority()),
+applied(base),
+donationList(nullptr),
+blockedOn(nullptr),
+raisedCount(0)
+{
+    // A null handle would have given us the caller's priority.
+    configASSERT(task_.getTaskHandle());
+}
+
+void RpcServer::basePriority(TaskPriority priority_) {
+    taskENTER_CRITICAL();
+    base = priority_;
+    update();
+    taskEXIT_CRITICAL();
+}
+
+void RpcServer::donate(RpcDonation& donation) {
+    donation.next = donationList;
+    donationList = &donation;
+    if(donation.priority > applied) raisedCount++;
+    update();
+}
+
+void RpcServer::withdraw(RpcDonation& donation) {
+    for(RpcDonation** ptr = &donationList; *ptr; ptr = &(*ptr)->next) {
+        if(*ptr == &donation) {
+            *ptr = donation.next;
+            break;
+        }
+    }
+    update();
+}
+
+void RpcServer::update() {
+    RpcServer* srv = this;
+    while(srv) {
+        TaskPriority prio = srv->base;
+        for(RpcDonation* donation = srv->donationList; donation; donation = donation->next) {
+            if(donation->priority > prio) prio = donation->priority;
+        }
+        if(prio == srv->applied) break;
+        srv->applied = prio;
+        srv->server.priority(prio);
+        // Pass the change on to the server we are waiting on, if any.
+        if(!srv->blockedOn) break;
+        srv->blockedOn->priority = prio;
+        // A call still waiting to be received must move to its new place in the queue.
+        srv->blockedOn->channel->reorder(*srv->blockedOn);
+        srv = srv->blockedOn->target;
+    }
+}
+
+void RpcServer::notifyGive(TaskHandle_t task) {
+#if FREERTOS_VERSION_ALL >= 10'004'000
+    xTaskNotifyGiveIndexed(task, FREERTOSCPP_NOTIFY_INDEX);
+#else
+    xTaskNotifyGive(task);
+#endif
+}
+
+void RpcServer::notifyTake(TickType_t time) {
+#if FREERTOS_VERSION_ALL >= 10'004'000
+    ulTaskNotifyTakeIndexed(FREERTOSCPP_NOTIFY_INDEX, pdTRUE, time);
+#else
+    ulTaskNotifyTake(pdTRUE, time);
+#endif
+}
+
+#endif // INCLUDE_vTaskPrioritySet && INCLUDE_uxTaskPriorityGet
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
@@ -0,0 +1,398 @@
+/**
+ * @file RpcChannel.h
+ * @brief Request/Reply Channel with Priority Donation
+ *
+ * Kernel queues don't pass priority to the task reading them, so a high priority client
+ * sending a request to a low priority server waits behind every medium priority task.
+ * An RpcChannel has the server take on the priority of its most urgent pending client
+ * until the reply, like Mutex priority inheritance.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_RPCCHANNEL_H_
+#define FREERTOSPP_RPCCHANNEL_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if INCLUDE_vTaskPrioritySet && INCLUDE_uxTaskPriorityGet
+
+class RpcServer;
+class RpcChannelBase;
+
+/**
+ * @brief A priority donated to an RpcServer by a pending call.
+ * @ingroup FreeRTOSCpp
+ */
+struct RpcDonation {
+    RpcDonation*    next;
+    RpcServer*      target;     ///< The server the priority is donated to.
+    RpcChannelBase* channel;    ///< The channel the call is queued on.
+    TaskPriority    priority;   ///< The priority donated.
+};
+
+/**
+ * @brief Type independent part of RpcChannel, so RpcServer can reach a channel's queue.
+ * @ingroup FreeRTOSCpp
+ */
+class RpcChannelBase {
+    friend class RpcServer;
+protected:
+    RpcChannelBase() {}
+    virtual ~RpcChannelBase() {}
+    /// The donation's priority changed, move its call if still queued. Called in a critical section.
+    virtual void reorder(RpcDonation& donation) = 0;
+};
+
+/**
+ * @brief Server side priority state for RpcChannels.
+ *
+ * One per server task, shared by all the channels it serves. The task runs at the highest
+ * of its base priority and the priorities donated by the calls pending on it. Donations
+ * nest: each pending call is its own donation, and when one is withdrawn the priority
+ * drops to the highest still outstanding, not straight back to the base.
+ *
+ * If the server is itself a client of another server (passing itself as the self
+ * parameter of RpcChannel::call()), the priority it has been donated is passed on along
+ * the chain, and updated if it changes while that call is outstanding, including its place
+ * in the queue if the call hasn't been received yet.
+ *
+ * The base priority is recorded at construction, use basePriority() to change it, as
+ * setting the task priority directly will be overridden by the next donation change.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class RpcServer {
+    template<class Req, class Rep> friend class RpcChannel;
+public:
+    /**
+     * @brief Constructor
+     * @param task_ The server task, its current priority is taken as the base priority.
+     * It must already exist, so start() a LazyTask first.
+     */
+    RpcServer(TaskBase& task_);
+
+    /**
+     * @brief The server task.
+     */
+    TaskBase& task() const { return server; }
+    /**
+     * @brief Get the base priority.
+     */
+    TaskPriority basePriority() const { return base; }
+    /**
+     * @brief Change the base priority.
+     */
+    void basePriority(TaskPriority priority_);
+    /**
+     * @brief The priority the server is running at, including donations.
+     */
+    TaskPriority priority() const { return applied; }
+    /**
+     * @brief Number of times a donation raised the server's priority.
+     */
+    uint32_t donations() const { return raisedCount; }
+
+private:
+    /// Add a donation. Called in a critical section.
+    void donate(RpcDonation& donation);
+    /// Remove a donation. Called in a critical section.
+    void withdraw(RpcDonation& donation);
+    /// Apply the highest donation, and pass it along the chain. Called in a critical section.
+    void update();
+
+    static void notifyGive(TaskHandle_t task);
+    static void notifyTake(TickType_t time);
+
+    TaskBase&       server;
+    TaskPriority    base;
+    TaskPriority    applied;
+    RpcDonation*    donationList;
+    RpcDonation*    blockedOn;      ///< Our donation to another server while we are its client.
+    uint32_t        raisedCount;
+
+#if __cplusplus < 201101L
+    RpcServer(RpcServer const&);      ///< We are not copyable.
+    void operator =(RpcServer const&);  ///< We are not assignable.
+#else
+    RpcServer(RpcServer const&) = delete;      ///< We are not copyable.
+    void operator =(RpcServer const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Request/Reply Channel with Priority Donation.
+ *
+ * Clients make a synchronous call() with a request, and get back the reply. While the call
+ * is pending or being served, the client's priority is donated to the server. The server
+ * gets requests with receive(), highest priority client first (FIFO among equals), and
+ * answers each with reply(), which withdraws that client's donation.
+ *
+ * The request and reply are not copied into the channel, the server reads and writes them
+ * in the client's call frame, so there is no limit to the number of pending calls.
+ *
+ * Blocking uses the task notification at FREERTOSCPP_NOTIFY_INDEX, for both the clients
+ * and the server, so configTASK_NOTIFICATION_ARRAY_ENTRIES must be at least 2. On kernels
+ * before 10.4 that is index 0, and those tasks must not also use TaskBase give()/take().
+ *
+ * Example Usage:
+ * @code
+ * class FlashServer : public TaskClassS<512> {
+ * public:
+ *     FlashServer() : TaskClassS<512>("Flash", TaskPrio_Low), rpc(*this), channel(rpc) {}
+ *     void task() override {
+ *         while(1) {
+ *             RpcChannel<FlashReq, FlashRep>::Call* call = channel.receive();
+ *             FlashRep rep = doRequest(call->request());
+ *             channel.reply(call, rep);
+ *         }
+ *     }
+ *     RpcServer rpc;
+ *     RpcChannel<FlashReq, FlashRep> channel;
+ * };
+ *
+ * // In a client
+ * FlashRep rep;
+ * flashServer.channel.call(req, rep);
+ * @endcode
+ *
+ * @tparam Req The request type.
+ * @tparam Rep The reply type.
+ * @ingroup FreeRTOSCpp
+ */
+template<class Req, class Rep> class RpcChannel : public RpcChannelBase {
+#if FREERTOS_VERSION_ALL >= 10'004'000
+    // Taking the notification clears it, so sharing index 0 would swallow the task's own give()s.
+    // (sizeof(Req) just makes the check wait until the template is used.)
+    static_assert(sizeof(Req) && FREERTOSCPP_NOTIFY_INDEX != 0 && FREERTOSCPP_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+                  "RpcChannel needs configTASK_NOTIFICATION_ARRAY_ENTRIES > 1");
+#endif
+public:
+    /**
+     * @brief A call in progress.
+     *
+     * Lives in the client's call(), and is handed to the server by receive().
+     */
+    class Call {
+        friend class RpcChannel;
+    public:
+        /// The client's request.
+        Req const& request() const { return *req; }
+        /// The priority the client donated.
+        TaskPriority priority() const { return donation.priority; }
+    private:
+        enum State { Pending, InService, Done };
+
+        Req const*      req;
+        Rep*            rep;
+        TaskHandle_t    client;
+        RpcServer*      self;
+        Call*           next;
+        RpcDonation     donation;
+        volatile State  state;
+    };
+
+    /**
+     * @brief Constructor
+     * @param server_ The server that will serve this channel.
+     */
+    RpcChannel(RpcServer& server_) : server(server_), pendingList(nullptr) {}
+
+    /**
+     * @brief Make a call.
+     *
+     * Donates our priority to the server until the reply.
+     *
+     * @param req The request.
+     * @param rep Where the reply is put.
+     * @param wait How long to wait for the server to take the request. Once the server
+     * has taken it, the call waits for the reply.
+     * @param self If the calling task is itself an RpcServer, pass it so any priority
+     * donated to us is passed on to this server.
+     * @return true if the reply was received, false if the server didn't take the request in time.
+     */
+    bool call(Req const& req, Rep& rep, TickType_t wait = portMAX_DELAY, RpcServer* self = nullptr) {
+        Call c;
+        c.req = &req;
+        c.rep = &rep;
+        c.client = xTaskGetCurrentTaskHandle();
+        c.self = self;
+        c.state = Call::Pending;
+        c.donation.target = &server;
+        c.donation.channel = this;
+        c.donation.priority = self ? self->priority() : static_cast<TaskPriority>(uxTaskPriorityGet(nullptr));
+        TimeOut_t timeout;
+        vTaskSetTimeOutState(&timeout);
+
+        taskENTER_CRITICAL();
+        insert(c);
+        server.donate(c.donation);
+        if(self) self->blockedOn = &c.donation;
+        taskEXIT_CRITICAL();
+        RpcServer::notifyGive(server.task().getTaskHandle());
+
+        while(1) {
+            RpcServer::notifyTake(wait);
+            taskENTER_CRITICAL();
+            if(c.state == Call::Done) {
+                taskEXIT_CRITICAL();
+                return true;
+            }
+            if(c.state == Call::Pending && xTaskCheckForTimeOut(&timeout, &wait)) {
+                unlink(c);
+                server.withdraw(c.donation);
+                if(self) self->blockedOn = nullptr;
+                taskEXIT_CRITICAL();
+                return false;
+            }
+            if(c.state == Call::InService) wait = portMAX_DELAY;
+            taskEXIT_CRITICAL();
+        }
+    }
+#if FREERTOSCPP_USE_CHRONO
+    bool call(Req const& req, Rep& rep, Time_ms wait, RpcServer* self = nullptr) {
+        return call(req, rep, ms2ticks(wait), self);
+    }
+#endif
+
+    /**
+     * @brief Get the next call to serve.
+     *
+     * Only to be called by the server task.
+     *
+     * @param wait How long to wait for a call.
+     * @return The call, or nullptr if timed out.
+     */
+    Call* receive(TickType_t wait = portMAX_DELAY) {
+        TimeOut_t timeout;
+        vTaskSetTimeOutState(&timeout);
+        while(1) {
+            taskENTER_CRITICAL();
+            Call* c = pendingList;
+            if(c) {
+                pendingList = c->next;
+                c->state = Call::InService;
+                taskEXIT_CRITICAL();
+                return c;
+            }
+            if(wait == 0 || xTaskCheckForTimeOut(&timeout, &wait)) {
+                taskEXIT_CRITICAL();
+                return nullptr;
+            }
+            taskEXIT_CRITICAL();
+            RpcServer::notifyTake(wait);
+        }
+    }
+#if FREERTOSCPP_USE_CHRONO
+    Call* receive(Time_ms wait) { return receive(ms2ticks(wait)); }
+#endif
+
+    /**
+     * @brief Reply to a call.
+     *
+     * Withdraws the client's donation, and wakes the client. The call can't be used after this.
+     * @param c The call from receive().
+     * @param rep The reply.
+     */
+    void reply(Call* c, Rep const& rep) {
+        *c->rep = rep;
+        taskENTER_CRITICAL();
+        TaskHandle_t client = c->client;
+        server.withdraw(c->donation);
+        if(c->self) c->self->blockedOn = nullptr;
+        c->state = Call::Done;
+        taskEXIT_CRITICAL();
+        RpcServer::notifyGive(client);
+    }
+
+    /**
+     * @brief Number of calls waiting to be received.
+     */
+    unsigned pending() const {
+        unsigned n = 0;
+        taskENTER_CRITICAL();
+        for(Call* c = pendingList; c; c = c->next) n++;
+        taskEXIT_CRITICAL();
+        return n;
+    }
+
+protected:
+    void reorder(RpcDonation& donation) override {
+        for(Call* c = pendingList; c; c = c->next) {
+            if(&c->donation == &donation) {
+                unlink(*c);
+                insert(*c);
+                break;
+            }
+        }
+    }
+
+private:
+    /// Add to the pending list, highest priority first. Called in a critical section.
+    void insert(Call& c) {
+        Call** ptr = &pendingList;
+        while(*ptr && (*ptr)->donation.priority >= c.donation.priority) ptr = &(*ptr)->next;
+        c.next = *ptr;
+        *ptr = &c;
+    }
+    /// Remove from the pending list. Called in a critical section.
+    void unlink(Call& c) {
+        for(Call** ptr = &pendingList; *ptr; ptr = &(*ptr)->next) {
+            if(*ptr == &c) {
+                *ptr = c.next;
+                break;
+            }
+        }
+    }
+
+    RpcServer&  server;
+    Call*       pendingList;
+
+#if __cplusplus < 201101L
+    RpcChannel(RpcChannel const&);      ///< We are not copyable.
+    void operator =(RpcChannel const&);  ///< We are not assignable.
+#else
+    RpcChannel(RpcChannel const&) = delete;      ///< We are not copyable.
+    void operator =(RpcChannel const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#endif // INCLUDE_vTaskPrioritySet && INCLUDE_uxTaskPriorityGet
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_RPCCHANNEL_H_ */
@@ -0,0 +1,428 @@
+/**
+ * @file SegmentedQueue.h
+ * @brief Growable Queue built from Pooled Segments
+ *
+ * A queue that grows during a burst by linking fixed size segments taken from a pool,
+ * and gives them back as it drains, so several queues can share the RAM for their bursts
+ * rather than each being sized for its own worst case.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_SEGMENTEDQUEUE_H_
+#define FREERTOSPP_SEGMENTEDQUEUE_H_
+
+#include "FreeRTOScpp.h"
+#include "SemaphoreCPP.h"
+#include "task.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief A segment of a SegmentedQueue.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned segmentItems> struct QueueSegment {
+    QueueSegment*   next;
+    T               items[segmentItems];
+};
+
+/**
+ * @brief Pool of segments for SegmentedQueues.
+ *
+ * Base class, see SegmentPool for the class that provides the storage.
+ *
+ * @tparam T The type of object to be placed on the queues.
+ * @tparam segmentItems The number of items in each segment.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned segmentItems> class SegmentPoolBase {
+public:
+    typedef QueueSegment<T, segmentItems> Segment;
+
+    /**
+     * @brief Number of segments currently free in the pool.
+     */
+    unsigned available() const { return freeCount.count(); }
+
+    /**
+     * @brief Take a segment from the pool.
+     * @param wait How long to wait for a segment to be freed.
+     * @return The segment, or nullptr if none available in time.
+     */
+    Segment* alloc(TickType_t wait) {
+        if(!freeCount.take(wait)) return nullptr;
+        return pop();
+    }
+    /**
+     * @brief Take a segment from the pool from an ISR.
+     * @param waswoken Flag variable to determine if context switch is needed.
+     * @return The segment, or nullptr if none available.
+     */
+    Segment* alloc_ISR(portBASE_TYPE& waswoken) {
+        if(!freeCount.take_ISR(waswoken)) return nullptr;
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        Segment* seg = freeList;
+        freeList = seg->next;
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        return seg;
+    }
+    /**
+     * @brief Return a segment to the pool.
+     */
+    void release(Segment* seg) {
+        taskENTER_CRITICAL();
+        seg->next = freeList;
+        freeList = seg;
+        taskEXIT_CRITICAL();
+        freeCount.give();
+    }
+    /**
+     * @brief Return a segment to the pool from an ISR.
+     */
+    void release_ISR(Segment* seg, portBASE_TYPE& waswoken) {
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        seg->next = freeList;
+        freeList = seg;
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        freeCount.give_ISR(waswoken);
+    }
+
+protected:
+    SegmentPoolBase(Segment* segments, unsigned count, char const* name) :
+        freeCount(count, count, name),
+        freeList(nullptr)
+    {
+        for(unsigned i = 0; i < count; i++) {
+            segments[i].next = freeList;
+            freeList = &segments[i];
+        }
+    }
+
+private:
+    Segment* pop() {
+        taskENTER_CRITICAL();
+        Segment* seg = freeList;
+        freeList = seg->next;
+        taskEXIT_CRITICAL();
+        return seg;
+    }
+
+    CountingSemaphore   freeCount;
+    Segment*            freeList;
+
+#if __cplusplus < 201101L
+    SegmentPoolBase(SegmentPoolBase const&);      ///< We are not copyable.
+    void operator =(SegmentPoolBase const&);  ///< We are not assignable.
+#else
+    SegmentPoolBase(SegmentPoolBase const&) = delete;      ///< We are not copyable.
+    void operator =(SegmentPoolBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Pool of segments for SegmentedQueues.
+ *
+ * @tparam T The type of object to be placed on the queues.
+ * @tparam segmentItems The number of items in each segment.
+ * @tparam segments The number of segments in the pool.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned segmentItems, unsigned segments> class SegmentPool : public SegmentPoolBase<T, segmentItems> {
+    static_assert(segments > 0, "Pool needs segments");
+public:
+    /**
+     * @brief Constructor.
+     * @param name The name to register the pool's semaphore with.
+     */
+    SegmentPool(char const* name = nullptr) : SegmentPoolBase<T, segmentItems>(storage, segments, name) {}
+private:
+    typename SegmentPoolBase<T, segmentItems>::Segment storage[segments];
+};
+
+/**
+ * @brief Growable Queue built from Pooled Segments.
+ *
+ * Items are kept in FIFO order in a chain of segments. When the last segment is full a new
+ * one is taken from the pool, and when the first segment has been read out it is given back,
+ * so the queue only holds the RAM it needs for the items in it (rounded up to segments).
+ *
+ * The queue is limited to maxSegments segments. add() blocks (up to its timeout) when the
+ * queue is at that limit, or the pool is empty, until a segment is freed.
+ *
+ * Example Usage:
+ * @code
+ * SegmentPool<Message, 8, 12> messagePool;
+ * SegmentedQueue<Message, 8> radioQueue(messagePool, 8, "Radio");
+ * SegmentedQueue<Message, 8> uartQueue(messagePool, 4, "Uart");
+ * @endcode
+ *
+ * @tparam T The type of object to be placed on the queue, needs to be copy assignable.
+ * @tparam segmentItems The number of items in each segment.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned segmentItems> class SegmentedQueue {
+    static_assert(segmentItems > 0, "Segments need items");
+public:
+    typedef SegmentPoolBase<T, segmentItems> Pool;
+    typedef typename Pool::Segment Segment;
+
+    /**
+     * @brief Constructor.
+     * @param pool_ The pool to take segments from.
+     * @param maxSegments_ The most segments the queue may hold.
+     * @param name The name to register the queue's semaphores with.
+     */
+    SegmentedQueue(Pool& pool_, unsigned maxSegments_, char const* name = nullptr) :
+        pool(pool_),
+        items(maxSegments_ * segmentItems, 0, name),
+        quota(maxSegments_, maxSegments_),
+        head(nullptr),
+        tail(nullptr),
+        headIdx(0),
+        tailIdx(0),
+        count(0),
+        segCount(0)
+    {
+    }
+
+    /**
+     * @brief Destructor.
+     * Gives any segments back to the pool.
+     */
+    ~SegmentedQueue() {
+        while(head) {
+            Segment* seg = head;
+            head = seg->next;
+            pool.release(seg);
+        }
+    }
+
+    /**
+     * @brief add an item at end of the Queue.
+     * @param item The item to put on the Queue.
+     * @param time How long to wait for room if the Queue is full.
+     * @return True if successful
+     */
+    bool add(T const& item, TickType_t time = portMAX_DELAY) {
+        // Not counted here, a failure is already counted by the semaphore take that timed out.
+        return send(item, time);
+    }
+    /**
+     * @brief Get an item from the Queue.
+     * @param var Variable to place the item
+     * @param time How long to wait for an item to be available.
+     * @return True if an item returned.
+     */
+    bool pop(T& var, TickType_t time = portMAX_DELAY) {
+        if(!items.take(time)) return false;     // Counted by the semaphore
+        Segment* freed;
+        taskENTER_CRITICAL();
+        freed = remove(var);
+        taskEXIT_CRITICAL();
+        if(freed) {
+            pool.release(freed);
+            quota.give();
+        }
+        return true;
+    }
+#if FREERTOSCPP_USE_CHRONO
+    bool add(T const& item, Time_ms time) { return add(item, ms2ticks(time)); }
+    bool pop(T& var, Time_ms time) { return pop(var, ms2ticks(time)); }
+#endif
+
+    /**
+     * @brief add an item at end of the Queue.
+     *
+     * Note: Interrupt service routines should only call _ISR routines.
+     * @param item The item to put on the Queue.
+     * @param waswoken Flag variable to determine if context switch is needed.
+     * @return True if successful
+     */
+    bool add_ISR(T const& item, portBASE_TYPE& waswoken) {
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        bool ok = append(item);
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        if(!ok && quota.take_ISR(waswoken)) {
+            Segment* seg = pool.alloc_ISR(waswoken);
+            if(!seg) {
+                quota.give_ISR(waswoken);
+            } else {
+                saved = taskENTER_CRITICAL_FROM_ISR();
+                Segment* spare = link(seg);
+                ok = append(item);
+                taskEXIT_CRITICAL_FROM_ISR(saved);
+                if(spare) {
+                    pool.release_ISR(spare, waswoken);
+                    quota.give_ISR(waswoken);
+                }
+            }
+        }
+        if(ok) items.give_ISR(waswoken);
+        return FREERTOSCPP_PERF_CHECK(ok, perfQueueSendFail);
+    }
+    /**
+     * @brief Get an item from the Queue.
+     *
+     * Note: Interrupt service routines should only call _ISR routines.
+     * @param var Variable to place the item
+     * @param waswoken Flag variable to determine if context switch is needed.
+     * @return True if an item returned.
+     */
+    bool pop_ISR(T& var, portBASE_TYPE& waswoken) {
+        if(!items.take_ISR(waswoken)) return false;
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        Segment* freed = remove(var);
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        if(freed) {
+            pool.release_ISR(freed, waswoken);
+            quota.give_ISR(waswoken);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get number of items in the Queue.
+     */
+    unsigned waiting() const { return count; }
+    /**
+     * @brief Get number of segments the Queue is holding.
+     */
+    unsigned segments() const { return segCount; }
+
+private:
+    /// Put the item in the tail segment if there is room. Called in a critical section.
+    bool append(T const& item) {
+        if(!tail || tailIdx >= segmentItems) return false;
+        tail->items[tailIdx++] = item;
+        count++;
+        return true;
+    }
+
+    /**
+     * Link a new segment at the tail. Called in a critical section.
+     * @return The segment if another add already linked one in, to give back.
+     */
+    Segment* link(Segment* seg) {
+        if(tail && tailIdx < segmentItems) return seg;
+        seg->next = nullptr;
+        if(tail) {
+            tail->next = seg;
+        } else {
+            head = seg;
+            headIdx = 0;
+        }
+        tail = seg;
+        tailIdx = 0;
+        segCount++;
+        return nullptr;
+    }
+
+    /**
+     * Remove the first item. Called in a critical section.
+     * @return The segment emptied, to give back to the pool.
+     */
+    Segment* remove(T& var) {
+        var = head->items[headIdx++];
+        count--;
+        // Give back the head segment once read out, or once the queue has drained.
+        if(headIdx < segmentItems && !(count == 0 && head == tail)) return nullptr;
+        Segment* seg = head;
+        head = seg->next;
+        if(!head) {
+            tail = nullptr;
+            tailIdx = 0;
+        }
+        headIdx = 0;
+        segCount--;
+        return seg;
+    }
+
+    bool send(T const& item, TickType_t time) {
+        TickType_t start = xTaskGetTickCount();
+        TickType_t remaining = time;
+        while(1) {
+            taskENTER_CRITICAL();
+            bool ok = append(item);
+            taskEXIT_CRITICAL();
+            if(ok) {
+                items.give();
+                return true;
+            }
+            if(!quota.take(remaining)) return false;
+            if(time != portMAX_DELAY) {
+                TickType_t used = xTaskGetTickCount() - start;
+                remaining = used < time ? time - used : 0;
+            }
+            Segment* seg = pool.alloc(remaining);
+            if(!seg) {
+                quota.give();
+                return false;
+            }
+            taskENTER_CRITICAL();
+            Segment* spare = link(seg);
+            taskEXIT_CRITICAL();
+            if(spare) {
+                // Another task added a segment while we waited, use it.
+                pool.release(spare);
+                quota.give();
+            }
+        }
+    }
+
+    Pool&               pool;
+    CountingSemaphore   items;      ///< Items in the queue, for pop to wait on.
+    CountingSemaphore   quota;      ///< Segments we may still take from the pool.
+    Segment*            head;
+    Segment*            tail;
+    unsigned            headIdx;    ///< Next item to read in head.
+    unsigned            tailIdx;    ///< Next slot to write in tail.
+    unsigned            count;
+    unsigned            segCount;
+
+#if __cplusplus < 201101L
+    SegmentedQueue(SegmentedQueue const&);      ///< We are not copyable.
+    void operator =(SegmentedQueue const&);  ///< We are not assignable.
+#else
+    SegmentedQueue(SegmentedQueue const&) = delete;      ///< We are not copyable.
+    void operator =(SegmentedQueue const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_SEGMENTEDQUEUE_H_ */
@@ -42,6 +42,9 @@
 #include "Lock.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 #if FREERTOSCPP_USE_NAMESPACE
 namespace FreeRTOScpp {
@@ -112,7 +115,7 @@ public:
    * @param delay The number of ticks to wait for the semaphore
    */
   bool take(TickType_t delay = portMAX_DELAY) override {
-    return xSemaphoreTake(sema, delay);
+    return FREERTOSCPP_PERF_CHECK(xSemaphoreTake(sema, delay), perfSemaphoreTakeFail);
   }
   bool take_ISR(portBASE_TYPE& waswoken) {
     return xSemaphoreTakeFromISR(sema, &waswoken);
@@ -125,7 +128,7 @@ public:
    * @param delay The number of ticks to wait for the semaphore
    */
   bool take(Time_ms delay){
-    return xSemaphoreTake(sema, ms2ticks(delay));
+    return FREERTOSCPP_PERF_CHECK(xSemaphoreTake(sema, ms2ticks(delay)), perfSemaphoreTakeFail);
   }
 #endif
   /**
@@ -155,6 +158,114 @@ private:
 };
 
 typedef BinarySemaphore Semaphore [[deprecated("Rename to BinarySemaphore")]];
+
+#if configUSE_COUNTING_SEMAPHORES > 0
+/**
+ * @brief Counting Semaphore Wrapper.
+ *
+ * Like a BinarySemaphore, but can count up to a maximum number of gives, each
+ * of which allows one take to succeed. Typically used to count resources or events.
+ *
+ * Example Usage:
+ * @code
+ * CountingSemaphore slots(4, 4, "Slots");
+ *
+ * // In some task
+ * slots.take();
+ * ... // use one of the slots
+ * slots.give();
+ * @endcode
+ * @ingroup FreeRTOSCpp
+ */
+
+class CountingSemaphore : public Lockable {
+public:
+  /**
+   * @brief Constructor.
+   * @param maxCount The maximum count the semaphore can reach.
+   * @param initialCount The count the semaphore starts with.
+   * @param name Name to give semaphore, used for Debug Registry if setup
+   */
+  CountingSemaphore(UBaseType_t maxCount, UBaseType_t initialCount = 0, char const* name = nullptr) {
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	sema = xSemaphoreCreateCountingStatic(maxCount, initialCount, &semaBuffer);
+#else
+	sema = xSemaphoreCreateCounting(maxCount, initialCount);
+#endif
+#if configQUEUE_REGISTRY_SIZE > 0
+	if(name)
+	  vQueueAddToRegistry(sema, name);
+#endif
+  }
+  /**
+   * @brief Destructor.
+   *
+   * Delete the semaphore.
+   */
+  ~CountingSemaphore() {
+    vQueueDelete(sema);
+  }
+  /**
+   * @brief Give the Semaphore, increasing its count.
+   */
+  bool give() override {
+    return xSemaphoreGive(sema);
+  }
+
+  /**
+   * @brief Take the semaphore, decreasing its count.
+   *
+   * @param delay The number of ticks to wait for the semaphore
+   */
+  bool take(TickType_t delay = portMAX_DELAY) override {
+    return FREERTOSCPP_PERF_CHECK(xSemaphoreTake(sema, delay), perfSemaphoreTakeFail);
+  }
+  bool take_ISR(portBASE_TYPE& waswoken) {
+    return xSemaphoreTakeFromISR(sema, &waswoken);
+  }
+
+ #if FREERTOSCPP_USE_CHRONO
+  /**
+   * @brief Take the semaphore.
+   *
+   * @param delay The number of ticks to wait for the semaphore
+   */
+  bool take(Time_ms delay){
+    return FREERTOSCPP_PERF_CHECK(xSemaphoreTake(sema, ms2ticks(delay)), perfSemaphoreTakeFail);
+  }
+#endif
+  /**
+   * @brief Give the Semaphore inside an ISR
+   *
+   * @param waswoken The flag variable used to indicate if we need to run the
+   * scheduler when we exit the ISR.
+   */
+  bool give_ISR(portBASE_TYPE& waswoken) {
+    return xSemaphoreGiveFromISR(sema, &waswoken);
+  }
+  /**
+   * @brief Get the current count of the Semaphore.
+   */
+  UBaseType_t count() const {
+    return uxSemaphoreGetCount(sema);
+  }
+private:
+  SemaphoreHandle_t sema;
+
+#if __cplusplus < 201101L
+    CountingSemaphore(CountingSemaphore const&);      ///< We are not copyable.
+    void operator =(CountingSemaphore const&);  ///< We are not assignable.
+#else
+    CountingSemaphore(CountingSemaphore const&) = delete;      ///< We are not copyable.
+    void operator =(CountingSemaphore const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+    StaticSemaphore_t semaBuffer;
+#endif
+
+};
+#endif // configUSE_COUNTING_SEMAPHORES
 #if FREERTOSCPP_USE_NAMESPACE
 }   // namespace FreeRTOScpp
 #endif
@@ -0,0 +1,283 @@
+/**
+ * @file SpinLock.h
+ * @brief Per-Object Spin Locks for Short SMP Critical Sections
+ *
+ * On SMP kernels taskENTER_CRITICAL() takes one global spin lock, so short sections
+ * protecting unrelated data on different cores still serialize against each other. These
+ * locks protect just their own object, with FIFO fairness between cores.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_SPINLOCK_H_
+#define FREERTOSPP_SPINLOCK_H_
+
+#include "FreeRTOScpp.h"
+#include "Lock.h"
+#include "Atomic.h"
+#include <atomic>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#ifndef FREERTOSCPP_CACHE_LINE
+/**
+ * @def FREERTOSCPP_CACHE_LINE
+ * Cache line size the spin locks align their shared words to, so a core spinning on one
+ * word doesn't steal the line another core is writing.
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_CACHE_LINE  32
+#endif
+
+#ifndef FREERTOSCPP_SPIN_PAUSE
+/**
+ * @def FREERTOSCPP_SPIN_PAUSE
+ * Hint to the core that it is in a spin wait loop (like a yield or pause instruction).
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_SPIN_PAUSE()    ((void)0)
+#endif
+
+/**
+ * What a spin lock blocks on the local core while it is held (and while waiting for it).
+ * @ingroup FreeRTOSCpp
+ */
+enum SpinLockMode {
+    SpinLock_MaskInterrupts,    ///< Raise the interrupt mask to configMAX_SYSCALL_INTERRUPT_PRIORITY, usable from ISRs.
+    SpinLock_NoPreempt          ///< Disable preemption of the task, interrupts still run but must not use the lock.
+                                ///< Needs configUSE_TASK_PREEMPTION_DISABLE, else suspends the scheduler, which on SMP is a global lock.
+};
+
+/**
+ * @brief Common base for the Spin Locks.
+ *
+ * Spin locks busy wait, and are only for sections of a few dozen instructions that
+ * don't block. While held, the holder can't be switched out (or interrupted, depending on
+ * the mode), so it isn't holding up other cores spinning for it.
+ *
+ * The locks need std::atomic to be lock-free for their types (checked at compile time),
+ * so aren't usable on cores without atomic instructions, like the Cortex-M0.
+ *
+ * take() can't time out, as a spinning waiter can't give up its place in line, but a wait
+ * of 0 is a try lock that only takes the lock if it is free. Locks don't nest, a core
+ * taking a lock it holds deadlocks.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class SpinLockBase : public Lockable {
+protected:
+    SpinLockBase(SpinLockMode mode_) : mode(mode_), saved(0) {}
+
+    /// Block the local core from interfering, before spinning.
+    UBaseType_t enter() {
+        if(mode == SpinLock_MaskInterrupts) return portSET_INTERRUPT_MASK_FROM_ISR();
+#if configUSE_TASK_PREEMPTION_DISABLE
+        vTaskPreemptionDisable(nullptr);
+#else
+        vTaskSuspendAll();
+#endif
+        return 0;
+    }
+    /// Undo enter(), after releasing.
+    void exit(UBaseType_t mask) {
+        if(mode == SpinLock_MaskInterrupts) {
+            portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+            return;
+        }
+#if configUSE_TASK_PREEMPTION_DISABLE
+        vTaskPreemptionEnable(nullptr);
+#else
+        xTaskResumeAll();
+#endif
+    }
+
+    SpinLockMode    mode;
+    UBaseType_t     saved;      ///< enter() state of the holder.
+};
+
+/**
+ * @brief Ticket Spin Lock.
+ *
+ * Each taker draws a ticket, and waits for it to be served, so the lock is granted in
+ * FIFO order. All waiters spin reading the one serving word, so suits locks with only a
+ * few cores contending.
+ *
+ * Example Usage:
+ * @code
+ * TicketSpinLock statsLock;
+ *
+ * {
+ *     TypedLock<TicketSpinLock> lock(statsLock);
+ *     stats.count++;
+ *     stats.total += value;
+ * }
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class TicketSpinLock final : public SpinLockBase {
+    // A lock emulated in a library could itself be taken by another core while we spin.
+    static_assert(AtomicNative<uint32_t>::value, "TicketSpinLock needs lock-free 32 bit atomics");
+public:
+    /**
+     * @brief Constructor
+     * @param mode_ What to block on the local core while held.
+     */
+    TicketSpinLock(SpinLockMode mode_ = SpinLock_MaskInterrupts) : SpinLockBase(mode_), next(0), serving(0) {}
+
+    /**
+     * @brief Take the lock.
+     * @param wait 0 to only take the lock if free, otherwise wait as long as needed.
+     * @return true if the lock was taken.
+     */
+    bool take(TickType_t wait = portMAX_DELAY) override {
+        UBaseType_t mask = enter();
+        if(wait == 0) {
+            uint32_t ticket = serving.load(std::memory_order_relaxed);
+            if(!next.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                exit(mask);
+                return false;
+            }
+        } else {
+            uint32_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+            while(serving.load(std::memory_order_acquire) != ticket) {
+                FREERTOSCPP_SPIN_PAUSE();
+            }
+        }
+        saved = mask;
+        return true;
+    }
+    /**
+     * @brief Release the lock.
+     */
+    bool give() override {
+        UBaseType_t mask = saved;
+        // Only the holder writes serving.
+        serving.store(serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        exit(mask);
+        return true;
+    }
+
+private:
+    alignas(FREERTOSCPP_CACHE_LINE) std::atomic<uint32_t> next;
+    alignas(FREERTOSCPP_CACHE_LINE) std::atomic<uint32_t> serving;
+};
+
+/**
+ * @brief MCS Queue Spin Lock.
+ *
+ * Waiters form a queue, each spinning on a flag in its own cache line that its
+ * predecessor clears on release, so waiting cores don't contend for a shared line
+ * however many there are. Grants the lock in FIFO order.
+ *
+ * Queue nodes are per core, which is why a lock can't be taken twice on one core.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class McsSpinLock final : public SpinLockBase {
+public:
+    /**
+     * @brief Constructor
+     * @param mode_ What to block on the local core while held.
+     */
+    McsSpinLock(SpinLockMode mode_ = SpinLock_MaskInterrupts) : SpinLockBase(mode_), tail(nullptr) {}
+
+    /**
+     * @brief Take the lock.
+     * @param wait 0 to only take the lock if free, otherwise wait as long as needed.
+     * @return true if the lock was taken.
+     */
+    bool take(TickType_t wait = portMAX_DELAY) override {
+        UBaseType_t mask = enter();
+        // Can't migrate now, so our core's node is ours.
+        Node& me = nodes[currentCore()];
+        me.next.store(nullptr, std::memory_order_relaxed);
+        me.locked.store(true, std::memory_order_relaxed);
+        if(wait == 0) {
+            Node* expected = nullptr;
+            if(!tail.compare_exchange_strong(expected, &me, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                exit(mask);
+                return false;
+            }
+        } else {
+            Node* prev = tail.exchange(&me, std::memory_order_acq_rel);
+            if(prev) {
+                prev->next.store(&me, std::memory_order_release);
+                while(me.locked.load(std::memory_order_acquire)) {
+                    FREERTOSCPP_SPIN_PAUSE();
+                }
+            }
+        }
+        saved = mask;
+        return true;
+    }
+    /**
+     * @brief Release the lock.
+     */
+    bool give() override {
+        UBaseType_t mask = saved;
+        Node& me = nodes[currentCore()];
+        Node* succ = me.next.load(std::memory_order_acquire);
+        if(!succ) {
+            Node* expected = &me;
+            if(tail.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                exit(mask);
+                return true;
+            }
+            // A successor is queued, but hasn't linked in yet.
+            while(!(succ = me.next.load(std::memory_order_acquire))) {
+                FREERTOSCPP_SPIN_PAUSE();
+            }
+        }
+        succ->locked.store(false, std::memory_order_release);
+        exit(mask);
+        return true;
+    }
+
+private:
+    struct alignas(FREERTOSCPP_CACHE_LINE) Node {
+        std::atomic<Node*>  next;
+        std::atomic<bool>   locked;
+    };
+
+    alignas(FREERTOSCPP_CACHE_LINE) std::atomic<Node*> tail;
+    Node    nodes[FREERTOSCPP_CORES];
+
+    // As for TicketSpinLock.
+    static_assert(AtomicNative<Node*>::value && AtomicNative<bool>::value, "McsSpinLock needs lock-free pointer and bool atomics");
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_SPINLOCK_H_ */
@@ -0,0 +1,279 @@
+/**
+ * @file StackOverlay.h
+ * @brief Shared Stack Region for Mutually Exclusive Tasks
+ *
+ * Tasks for operating modes that never run at the same time, like a firmware updater and
+ * the normal application, each reserve their own static stack with TaskS. A StackOverlay
+ * is one region, sized for the largest of a declared set of tasks, that each of them is
+ * created in when its mode starts, one at a time.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_STACKOVERLAY_H_
+#define FREERTOSPP_STACKOVERLAY_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+#include "LazyTask.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 ) && INCLUDE_vTaskDelete && \
+    (FREERTOSCPP_CORES == 1 || (INCLUDE_vTaskSuspend && INCLUDE_eTaskGetState))
+
+class OverlayTask;
+
+/**
+ * @brief Shared Stack Region.
+ *
+ * Holds the TCB and stack, storage provided by StackOverlay, and which task is using them.
+ * @ingroup FreeRTOSCpp
+ */
+class StackOverlayBase {
+    friend class OverlayTask;
+protected:
+    StackOverlayBase(StackType_t* stack_, uint32_t depth_) :
+        stack(stack_),
+        stackDepth(depth_),
+        owner(nullptr),
+        refusedCount(0)
+    {}
+
+public:
+    /**
+     * @brief The task currently created in the region, or nullptr.
+     */
+    OverlayTask* user() const { return owner; }
+    /**
+     * @brief Is a task currently using the region.
+     */
+    bool inUse() const { return owner != nullptr; }
+    /**
+     * @brief Size of the stack, in StackType_t words.
+     */
+    uint32_t depth() const { return stackDepth; }
+    /**
+     * @brief Number of times a task couldn't start as another was using the region.
+     */
+    uint32_t refused() const { return refusedCount; }
+
+private:
+    /// Claim the region for a task.
+    bool acquire(OverlayTask& task) {
+        taskENTER_CRITICAL();
+        bool ok = owner == nullptr;
+        if(ok) {
+            owner = &task;
+        } else {
+            refusedCount++;
+        }
+        taskEXIT_CRITICAL();
+        return ok;
+    }
+    /// Give up the region, after the task has been deleted.
+    void release(OverlayTask& task) {
+        taskENTER_CRITICAL();
+        if(owner == &task) owner = nullptr;
+        taskEXIT_CRITICAL();
+    }
+
+    StaticTask_t    tcb;
+    StackType_t*    stack;
+    uint32_t        stackDepth;
+    OverlayTask*    owner;
+    uint32_t        refusedCount;
+
+#if __cplusplus < 201101L
+    StackOverlayBase(StackOverlayBase const&);      ///< We are not copyable.
+    void operator =(StackOverlayBase const&);  ///< We are not assignable.
+#else
+    StackOverlayBase(StackOverlayBase const&) = delete;      ///< We are not copyable.
+    void operator =(StackOverlayBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Largest of a list of stack sizes.
+ */
+template<uint32_t first, uint32_t... rest> struct StackOverlayMax {
+    static constexpr uint32_t value = first > StackOverlayMax<rest...>::value ? first : StackOverlayMax<rest...>::value;
+};
+template<uint32_t last> struct StackOverlayMax<last> {
+    static constexpr uint32_t value = last;
+};
+
+/**
+ * @brief Shared Stack Region for Mutually Exclusive Tasks.
+ *
+ * Sized at compile time for the largest of the stack sizes of the tasks that will share it.
+ *
+ * Example Usage:
+ * @code
+ * StackOverlay<2048, 768> modeStack;      // Updater, Application
+ * OverlayTask updater(modeStack, "Update", &updateTask, TaskPrio_Mid);
+ * OverlayTask app(modeStack, "App", &appTask, TaskPrio_Mid);
+ *
+ * // Mode change, from a supervisor task
+ * app.stop();
+ * updater.start();
+ * @endcode
+ *
+ * @tparam sizes The stack sizes needed by each of the tasks sharing the region.
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t... sizes> class StackOverlay : public StackOverlayBase {
+public:
+    StackOverlay() : StackOverlayBase(storage, StackOverlayMax<sizes...>::value) {}
+private:
+    StackType_t storage[StackOverlayMax<sizes...>::value];
+};
+
+/**
+ * @brief Task Created in a StackOverlay.
+ *
+ * The task is created, as with LazyTaskS, by start() or the first give() or notify(), but
+ * only if no other task is using the overlay, otherwise they fail. stop() deletes the
+ * task and frees the overlay for the next.
+ *
+ * stop() must be called from another task (typically the one managing the mode change),
+ * not the overlay task itself, as the kernel is still using the TCB and stack of a task
+ * that deletes itself until the idle task has cleaned it up.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class OverlayTask : public LazyTaskBase {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param overlay_ The stack region to create the task in.
+     * @param name The name of the task.
+     * @param taskfun The function implementing the task, should have type void (*taskfun)(void *)
+     * @param priority_ The priority of the task. Use the TaskPriority enum values or a related value converted to a TaskPriority
+     * @param myParm the parameter passed to taskFun. Defaults to NULL.
+     *
+     * The task is not created until started.
+     */
+    OverlayTask(StackOverlayBase& overlay_, char const* name, void (*taskfun)(void*), TaskPriority priority_, void* myParm = nullptr) :
+        LazyTaskBase(name, taskfun, priority_, myParm),
+        overlay(overlay_)
+    {}
+
+    /**
+     * @brief Destructor.
+     *
+     * Deletes the task, if running, and frees the overlay.
+     */
+    virtual ~OverlayTask() { stop(); }
+
+    /**
+     * @brief Delete the task and free the overlay.
+     *
+     * Must not be called from the task itself.
+     */
+    void stop() {
+        TaskHandle_t handle = taskHandle;
+        if(!handle) return;
+        configASSERT(handle != xTaskGetCurrentTaskHandle());
+#if FREERTOSCPP_CORES > 1
+        // A task running on another core has its deletion deferred to the idle task, which
+        // would still be using the overlay, so get it off its core first.
+        vTaskSuspend(handle);
+        while(eTaskGetState(handle) == eRunning) {
+            taskYIELD();
+        }
+#endif
+        indexRemove();
+        vTaskDelete(handle);
+        taskHandle = nullptr;
+        overlay.release(*this);
+    }
+
+protected:
+    void create() override {
+        if(!overlay.acquire(*this)) return;
+        taskHandle = FREERTOSCPP_PERF_CHECK(xTaskCreateStatic(taskfun, name, overlay.stackDepth, myParm, createPriority, overlay.stack, &overlay.tcb), perfTaskCreateFail);
+        if(!taskHandle) overlay.release(*this);
+    }
+
+private:
+    StackOverlayBase&   overlay;
+};
+
+/**
+ * @brief Class based Task Created in a StackOverlay.
+ *
+ * Derive from OverlayTaskClass and the 'task()' member function will get called as the task,
+ * once the task is started.
+ *
+ * If task() returns, the task waits to be stopped, rather than deleting itself, as the
+ * overlay can't be reused until it has been deleted by another task.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class OverlayTaskClass : public TaskClassBase, public OverlayTask {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param overlay_ The stack region to create the task in.
+     * @param name The name of the task.
+     * @param priority_ The priority of the task. Use the TaskPriority enum values or a related value converted to a TaskPriority
+     */
+    OverlayTaskClass(StackOverlayBase& overlay_, char const* name, TaskPriority priority_) :
+        OverlayTask(overlay_, name, &overlayTaskThunk, priority_, static_cast<TaskClassBase*>(this))
+    {}
+
+    /**
+     * @brief task function.
+     * The member function task needs to
+     */
+    void task() override = 0;
+
+protected:
+    /// Task function, the object is already constructed, so no startup handshake is needed.
+    static void overlayTaskThunk(void* parm) {
+        static_cast<TaskClassBase*>(parm)->task();
+        while(1) {
+            vTaskDelay(portMAX_DELAY);
+        }
+    }
+};
+
+#endif // configSUPPORT_STATIC_ALLOCATION && INCLUDE_vTaskDelete
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_STACKOVERLAY_H_ */
@@ -38,6 +38,10 @@
 #include "FreeRTOScpp.h"
 
 #include "stream_buffer.h"
+#include "Watermark.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 #if FREERTOSCPP_USE_NAMESPACE
 namespace FreeRTOScpp {
@@ -52,26 +56,26 @@ namespace FreeRTOScpp {
      */
 class StreamBufferBase {
 public:
-    StreamBufferBase(StreamBufferHandle_t sbHandle) : streamHandle(sbHandle) {}
+    StreamBufferBase(StreamBufferHandle_t sbHandle) : streamHandle(sbHandle), watermark(nullptr) {}
     virtual ~StreamBufferBase() { }
 
     size_t send(const void* data, size_t len, TickType_t delay = portMAX_DELAY) 
-        {return xStreamBufferSend(streamHandle, data, len, delay);} 
+        {return levelChanged(FREERTOSCPP_PERF_CHECK(xStreamBufferSend(streamHandle, data, len, delay), perfStreamSendFail));} 
 #if FREERTOSCPP_USE_CHRONO
     size_t send(const void* data, size_t len, Time_ms delay) 
-        {return xStreamBufferSend(streamHandle, data, len, ms2ticks(delay));} 
+        {return levelChanged(FREERTOSCPP_PERF_CHECK(xStreamBufferSend(streamHandle, data, len, ms2ticks(delay)), perfStreamSendFail));} 
 #endif        
     size_t send_ISR(const void* data, size_t len, BaseType_t &wasWoken) 
-        {return xStreamBufferSendFromISR(streamHandle, data, len, &wasWoken);} 
+        {return levelChanged_ISR(FREERTOSCPP_PERF_CHECK(xStreamBufferSendFromISR(streamHandle, data, len, &wasWoken), perfStreamSendFail), wasWoken);} 
 
     size_t read(void* data, size_t len, TickType_t delay = portMAX_DELAY) 
-        {return xStreamBufferReceive(streamHandle, data, len, delay);} 
+        {return levelChanged(xStreamBufferReceive(streamHandle, data, len, delay));} 
 #if FREERTOSCPP_USE_CHRONO
     size_t read(void* data, size_t len, Time_ms delay) 
-        {return xStreamBufferReceive(streamHandle, data, len, ms2ticks(delay));} 
+        {return levelChanged(xStreamBufferReceive(streamHandle, data, len, ms2ticks(delay)));} 
 #endif        
     size_t read_ISR(void* data, size_t len, BaseType_t &wasWoken) 
-        {return xStreamBufferReceiveFromISR(streamHandle, data, len, &wasWoken);} 
+        {return levelChanged_ISR(xStreamBufferReceiveFromISR(streamHandle, data, len, &wasWoken), wasWoken);} 
 
     /// @brief  Get number of bytes of data available in the StreamBuffer
     /// @return The number of bytes that can be read
@@ -87,14 +91,38 @@ public:
 
     /// @brief Resets the buffer to empty
     /// @return True if done, stream can not be reset if a task is waiting on the StreamBuffer.
-    bool reset() { return xStreamBufferReset(streamHandle);}
+    bool reset() {
+        bool ok = xStreamBufferReset(streamHandle);
+        if(ok && watermark) watermark->updateFrom([this] { return xStreamBufferBytesAvailable(streamHandle); });
+        return ok;
+    }
 
     /// @brief Sets the Trigger Level for the StreamBuffer
     /// @param trigger the Trigger Level
     /// @return If trigger level was set (false means trigger bigger than the buffer size)
     bool trigger(size_t trigger) { return xStreamBufferSetTriggerLevel(streamHandle, trigger);}
 
+    /// @brief Attach a Watermark to the buffer
+    /// The Watermark is given the number of bytes waiting after each send/read.
+    /// @param wm The Watermark, or nullptr to remove it.
+    void setWatermark(Watermark* wm) {
+        watermark = wm;
+        if(wm) wm->update(xStreamBufferBytesAvailable(streamHandle));
+    }
+
     StreamBufferHandle_t streamHandle;
+protected:
+    /// Report the new level to the Watermark after a successful operation.
+    size_t levelChanged(size_t result) {
+        if(result && watermark) watermark->updateFrom([this] { return xStreamBufferBytesAvailable(streamHandle); });
+        return result;
+    }
+    size_t levelChanged_ISR(size_t result, BaseType_t& wasWoken) {
+        if(result && watermark) watermark->updateFrom_ISR([this] { return xStreamBufferBytesAvailable(streamHandle); }, wasWoken);
+        return result;
+    }
+
+    Watermark* watermark;
 };
 
 /**
@@ -224,4 +252,4 @@ public:
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -52,6 +52,9 @@
 #define TaskCPP_H
 
 #include "FreeRTOScpp.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 extern "C" {
 	extern void taskcpp_task_thunk(void*);
@@ -111,11 +114,25 @@ constexpr TaskPriority operator-(TaskPriority p, int offset) {
 	return static_cast<TaskPriority>(static_cast<int>(p) - offset);
 }
 
+#ifndef FREERTOSCPP_TASK_INDEX_SIZE
+/**
+ * @def FREERTOSCPP_TASK_INDEX_SIZE
+ * Number of hash buckets in the name index used by TaskBase::find(), 0 to disable the index.
+ * @ingroup FreeRTOSCpp
+ */
+#define FREERTOSCPP_TASK_INDEX_SIZE 16
+#endif
+
 /**
  * @brief Lowest Level Wrapper.
  * Create the specified task with a provided task function.
  *
  * If the TaskBase object is destroyed, the FreeRTOS Task will be deleted (if deletion has been enabled)
+ *
+ * The member functions are not virtual, and assume the task exists (a null handle would mean
+ * the calling task to the kernel). Until a LazyTask has been started, it must be notified
+ * through the LazyTask itself, which creates it first. Through a TaskBase reference (as from
+ * TaskGroup or an RpcServer) the notify and give functions assert the handle.
  * @ingroup FreeRTOSCpp
  * @todo Fully implement task manipulation functions
  *
@@ -128,14 +145,22 @@ protected:
 	 * @brief Default Constructor: Needs a subclass to fill in the handle later, so protected.
 	*/
 
-	TaskBase() : taskHandle(nullptr) {}
+	TaskBase() : taskHandle(nullptr)
+#if FREERTOSCPP_TASK_INDEX_SIZE
+	, indexNext(nullptr)
+#endif
+	{}
 
 public:
 	/**
 	 * @brief Constructor
 	 *
 	 */
-	TaskBase(TaskHandle_t handle) : taskHandle(handle) {
+	TaskBase(TaskHandle_t handle) : taskHandle(handle)
+#if FREERTOSCPP_TASK_INDEX_SIZE
+	, indexNext(nullptr)
+#endif
+	{
 
 	}
 
@@ -145,6 +170,7 @@ public:
 	   * If deletion is enabled, delete the task.
 	   */
 	  virtual ~TaskBase() {
+		indexRemove();
 #if INCLUDE_vTaskDelete
 		if(taskHandle){
 		    vTaskDelete(taskHandle);
@@ -157,6 +183,19 @@ public:
 	   * @return the task handle.
 	   */
 	  TaskHandle_t getTaskHandle() const { return taskHandle; }
+#if FREERTOSCPP_TASK_INDEX_SIZE
+	  /**
+	   * @brief Find a Task by name.
+	   *
+	   * Looks up the index the TaskS and TaskClassS wrappers register their names in, so unlike
+	   * xTaskGetHandle() doesn't walk the task lists. Tasks not created by the wrappers are not found.
+	   * If several tasks share a name, the last created is found.
+	   *
+	   * @param name The name of the Task.
+	   * @return The Task wrapper, or nullptr if not found.
+	   */
+	  static TaskBase* find(char const* name);
+#endif
       /**
        * @brief Delay for a period of time
        * @param time the number of ticks to delay
@@ -322,30 +361,30 @@ public:
 	   * Generic Task Notification operation
 	   */
 	  bool 			notify(uint32_t value, eNotifyAction act)
-	  	  	  	  	  	  { return xTaskNotify(taskHandle, value, act); }
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotify(taskHandle, value, act); }
 	  bool 			notify_ISR(uint32_t value, eNotifyAction act, portBASE_TYPE& waswoken)
-	  	  	  	  	  	  { return xTaskNotifyFromISR(taskHandle, value, act, &waswoken);}
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyFromISR(taskHandle, value, act, &waswoken);}
 	  bool 			notify_query(uint32_t value, eNotifyAction act, uint32_t &old)
-	  	  	  	  	  	  {return xTaskNotifyAndQuery(taskHandle, value, act, &old); }
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyAndQuery(taskHandle, value, act, &old); }
 	  bool 			notify_query_ISR(uint32_t value, eNotifyAction act, uint32_t &old, portBASE_TYPE& waswoken)
-	  	  	  	  	  	  {return xTaskNotifyAndQueryFromISR(taskHandle, value, act, &old, &waswoken); }
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyAndQueryFromISR(taskHandle, value, act, &old, &waswoken); }
 #if FREERTOS_VERSION_ALL >= 10'004'000
 	  bool 			notifyIndex(UBaseType_t idx, uint32_t value, eNotifyAction act)
-	  	  	  	  	  	  { return xTaskNotifyIndexed(taskHandle, idx, value, act); }
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyIndexed(taskHandle, idx, value, act); }
 	  bool 			notifyIndex_ISR(UBaseType_t idx, uint32_t value, eNotifyAction act, portBASE_TYPE& waswoken)
-	  	  	  	  	  	  { return xTaskNotifyIndexedFromISR(taskHandle, idx, value, act, &waswoken);}
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyIndexedFromISR(taskHandle, idx, value, act, &waswoken);}
 	  bool 			notifyIndex_query(UBaseType_t idx, uint32_t value, eNotifyAction act, uint32_t &old)
-	  	  	  	  	  	  {return xTaskNotifyAndQueryIndexed(taskHandle, idx, value, act, &old); }
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyAndQueryIndexed(taskHandle, idx, value, act, &old); }
 	  bool 			notifyIndex_query_ISR(UBaseType_t idx, uint32_t value, eNotifyAction act, uint32_t &old, portBASE_TYPE& waswoken)
-	  	  	  	  	  	  {return xTaskNotifyAndQueryIndexedFromISR(taskHandle, idx, value, act, &old, &waswoken); }
+	  	  	  	  	  	  { configASSERT(taskHandle); return xTaskNotifyAndQueryIndexedFromISR(taskHandle, idx, value, act, &old, &waswoken); }
 #endif
 
 #if FREERTOS_VERSION_ALL >= 10'003'000
-	  bool			notifyStateClear() { return xTaskNotifyStateClear(taskHandle); }
-	  uint32_t		notifyValueClear(uint32_t bits)	{ return ulTaskNotifyValueClear(taskHandle, bits); }
+	  bool			notifyStateClear() { configASSERT(taskHandle); return xTaskNotifyStateClear(taskHandle); }
+	  uint32_t		notifyValueClear(uint32_t bits)	{ configASSERT(taskHandle); return ulTaskNotifyValueClear(taskHandle, bits); }
 #if FREERTOS_VERSION_ALL >= 10'004'000
-	  bool			notifyStateClearIndex(UBaseType_t idx) { return xTaskNotifyStateClearIndexed(taskHandle, idx); }
-	  uint32_t		notifyValueClearIndex(UBaseType_t idx, uint32_t bits)	{ return ulTaskNotifyValueClearIndexed(taskHandle, idx, bits); }
+	  bool			notifyStateClearIndex(UBaseType_t idx) { configASSERT(taskHandle); return xTaskNotifyStateClearIndexed(taskHandle, idx); }
+	  uint32_t		notifyValueClearIndex(UBaseType_t idx, uint32_t bits)	{ configASSERT(taskHandle); return ulTaskNotifyValueClearIndexed(taskHandle, idx, bits); }
 #endif
 #endif
 	  /**
@@ -354,14 +393,14 @@ public:
 	   * Sends a notification to a task using a semaphore based protocol. Generally the task should we using
 	   * the take() function to receive the notification.
 	   */
-	  bool 			give() 		{ return xTaskNotifyGive(taskHandle); }
+	  bool 			give() 		{ configASSERT(taskHandle); return xTaskNotifyGive(taskHandle); }
 	  void 			give_ISR(portBASE_TYPE& waswoken)
-	  	  	  	  	  	  { vTaskNotifyGiveFromISR(taskHandle, &waswoken); }
+	  	  	  	  	  	  { configASSERT(taskHandle); vTaskNotifyGiveFromISR(taskHandle, &waswoken); }
 
 #if FREERTOS_VERSION_ALL >= 10'004'000
-	  bool 			giveIndex(UBaseType_t idx) 	{ return xTaskNotifyGiveIndexed(taskHandle, idx); }
+	  bool 			giveIndex(UBaseType_t idx) 	{ configASSERT(taskHandle); return xTaskNotifyGiveIndexed(taskHandle, idx); }
 	  void 			giveIndex_ISR(UBaseType_t idx, portBASE_TYPE& waswoken)
-	  	  	  	  	  	  { vTaskNotifyGiveIndexedFromISR(taskHandle, idx, &waswoken); }
+	  	  	  	  	  	  { configASSERT(taskHandle); vTaskNotifyGiveIndexedFromISR(taskHandle, idx, &waswoken); }
 #endif
 	  // Static as always affect the current (calling) task
 	  /**
@@ -415,7 +454,24 @@ public:
                           { return ulTaskNotifyTake(clear, ms2ticks(ticks)); }
 #endif
     protected:
+#if FREERTOSCPP_TASK_INDEX_SIZE
+	  /// Add the task to the name index, once created.
+	  void indexAdd();
+	  /// Remove the task from the name index, before deleting it.
+	  void indexRemove();
+#else
+	  void indexAdd() {}
+	  void indexRemove() {}
+#endif
+
 	  TaskHandle_t taskHandle;  ///< Handle for the task we are managing.
+#if FREERTOSCPP_TASK_INDEX_SIZE
+	private:
+	  static unsigned indexHash(char const* name);
+
+	  static TaskBase* taskIndex[FREERTOSCPP_TASK_INDEX_SIZE];
+	  TaskBase* indexNext;      ///< Next task in the same index bucket.
+#endif
 
 	private:
 #if __cplusplus < 201101L
@@ -459,10 +515,11 @@ public:
     	TaskBase() {
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
-	    	taskHandle = xTaskCreateStatic(taskfun, name, stackDepth, myParm, priority_, stack, &tcb);
+	    	taskHandle = FREERTOSCPP_PERF_CHECK(xTaskCreateStatic(taskfun, name, stackDepth, myParm, priority_, stack, &tcb), perfTaskCreateFail);
 #else
-	    	xTaskCreate(taskfun, name, stackSize, myParm, priority_, &taskHandle); 
+	    	(void) FREERTOSCPP_PERF_CHECK(xTaskCreate(taskfun, name, stackSize, myParm, priority_, &taskHandle) == pdPASS, perfTaskCreateFail);
 #endif
+	    	indexAdd();
     }
 
 private:
@@ -495,7 +552,8 @@ public:
   TaskS(char const*name, void (*taskfun)(void *), TaskPriority priority_,
        unsigned portSHORT stackSize, void * myParm = nullptr) :
 	   TaskBase() {
-	    xTaskCreate(taskfun, name, stackSize, myParm, priority_, &taskHandle);
+	    (void) FREERTOSCPP_PERF_CHECK(xTaskCreate(taskfun, name, stackSize, myParm, priority_, &taskHandle) == pdPASS, perfTaskCreateFail);
+	    indexAdd();
   }
 };
 
@@ -515,6 +573,12 @@ public:
    */
   virtual void task() = 0;
 
+protected:
+  friend void ::taskcpp_task_thunk(void*);
+  /**
+   * @brief Called when task() has returned, just before the task deletes itself.
+   */
+  virtual void taskEnded() {}
 };
 
 /**
@@ -560,6 +624,14 @@ public:
    */
   void task() override = 0;
 
+protected:
+  /**
+   * @brief Take the task out of the name index, and forget the handle, as the task is about to be deleted.
+   */
+  void taskEnded() override {
+	this->indexRemove();
+	this->taskHandle = nullptr;
+  }
 };
 
 
@@ -596,6 +668,14 @@ public:
    */
   void task() override = 0;
 
+protected:
+  /**
+   * @brief Take the task out of the name index, and forget the handle, as the task is about to be deleted.
+   */
+  void taskEnded() override {
+	this->indexRemove();
+	this->taskHandle = nullptr;
+  }
 };
 
 typedef TaskClassS<0> TaskClass;
@@ -34,6 +34,7 @@
 
 
 #include "TaskCpp.h"
+#include <string.h>
 
 #if FREERTOSCPP_USE_NAMESPACE
 using namespace FreeRTOScpp;
@@ -49,6 +50,8 @@ void taskcpp_task_thunk(void* parm) {
     TaskBase::take();
     myClass->task();
 #if INCLUDE_vTaskDelete
+    // Unindex first, or find() would return the wrapper of a deleted task.
+    myClass->taskEnded();
     vTaskDelete(nullptr);
 #else
     while(1) {
@@ -57,3 +60,56 @@ void taskcpp_task_thunk(void* parm) {
 #endif
 }    
 } // extern "C"
+
+#if FREERTOSCPP_TASK_INDEX_SIZE
+
+TaskBase* TaskBase::taskIndex[FREERTOSCPP_TASK_INDEX_SIZE];
+
+/**
+ * FNV-1a hash of the name, as far as the kernel keeps it.
+ */
+unsigned TaskBase::indexHash(char const* name) {
+    uint32_t hash = 2166136261U;
+    for(unsigned i = 0; i < configMAX_TASK_NAME_LEN - 1 && name[i]; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619U;
+    }
+    return hash % FREERTOSCPP_TASK_INDEX_SIZE;
+}
+
+void TaskBase::indexAdd() {
+    if(!taskHandle) return;
+    unsigned bucket = indexHash(pcTaskGetName(taskHandle));
+    taskENTER_CRITICAL();
+    indexNext = taskIndex[bucket];
+    taskIndex[bucket] = this;
+    taskEXIT_CRITICAL();
+}
+
+void TaskBase::indexRemove() {
+    if(!taskHandle) return;
+    // Search every bucket rather than hash the name, as the task may already have been deleted.
+    taskENTER_CRITICAL();
+    for(unsigned bucket = 0; bucket < FREERTOSCPP_TASK_INDEX_SIZE; ++bucket) {
+        for(TaskBase** ptr = &taskIndex[bucket]; *ptr; ptr = &(*ptr)->indexNext) {
+            if(*ptr == this) {
+                *ptr = indexNext;
+                taskEXIT_CRITICAL();
+                return;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+TaskBase* TaskBase::find(char const* name) {
+    unsigned bucket = indexHash(name);
+    taskENTER_CRITICAL();
+    TaskBase* task = taskIndex[bucket];
+    while(task && strncmp(pcTaskGetName(task->taskHandle), name, configMAX_TASK_NAME_LEN - 1) != 0) {
+        task = task->indexNext;
+    }
+    taskEXIT_CRITICAL();
+    return task;
+}
+
+#endif // FREERTOSCPP_TASK_INDEX_SIZE
@@ -0,0 +1,254 @@
+/**
+ * @file TaskGroup.h
+ * @brief Bulk Control of a Group of Tasks
+ *
+ * Mode changes often suspend, resume, re-prioritize or notify many tasks at once. Done one
+ * call at a time, each may reschedule, and the intermediate states (half the tasks in the
+ * new mode) are visible to the tasks involved. A TaskGroup applies the operation to all its
+ * members with the scheduler suspended, so there is one reschedule at the end.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_TASKGROUP_H_
+#define FREERTOSPP_TASKGROUP_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Bulk Control of a Group of Tasks.
+ *
+ * Holds references to the member tasks, storage provided by TaskGroup.
+ *
+ * Each bulk operation is done inside one vTaskSuspendAll()/xTaskResumeAll() section, so no
+ * member runs until all have been changed, and any context switch the operations call
+ * for is done once, when the scheduler is resumed.
+ *
+ * Bulk operations must not be called from an ISR, or with the scheduler already
+ * suspended.
+ *
+ * Members that don't have a task (yet), like a LazyTask that hasn't been started, are
+ * skipped, as the kernel would take their null handle as the calling task.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class TaskGroupBase {
+protected:
+    /**
+     * @brief Constructor
+     * @param tasks_ Storage for the member list.
+     * @param capacity_ Size of the storage.
+     */
+    TaskGroupBase(TaskBase** tasks_, unsigned capacity_) :
+        tasks(tasks_),
+        capacity(capacity_),
+        count(0)
+    {}
+
+public:
+    /**
+     * @brief Add a task to the group.
+     * @return false if the group is full.
+     */
+    bool add(TaskBase& task) {
+        if(count >= capacity) return false;
+        tasks[count++] = &task;
+        return true;
+    }
+    /**
+     * @brief Remove a task from the group.
+     * @return false if the task wasn't a member.
+     */
+    bool remove(TaskBase& task) {
+        for(unsigned i = 0; i < count; ++i) {
+            if(tasks[i] == &task) {
+                tasks[i] = tasks[--count];
+                return true;
+            }
+        }
+        return false;
+    }
+    /**
+     * @brief Number of tasks in the group.
+     */
+    unsigned size() const { return count; }
+
+#if INCLUDE_vTaskSuspend
+    /**
+     * @brief Suspend all the tasks in the group.
+     *
+     * If the calling task is a member, it is suspended last, after the scheduler is
+     * resumed, as the kernel doesn't allow the running task to suspend itself with the
+     * scheduler suspended.
+     */
+    void suspend() {
+        TaskHandle_t me = xTaskGetCurrentTaskHandle();
+        bool self = false;
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            if(tasks[i]->getTaskHandle() == me) {
+                self = true;
+            } else {
+                tasks[i]->suspend();
+            }
+        }
+        xTaskResumeAll();
+        if(self) vTaskSuspend(nullptr);
+    }
+    /**
+     * @brief Resume all the tasks in the group.
+     */
+    void resume() {
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            tasks[i]->resume();
+        }
+        xTaskResumeAll();
+    }
+#endif
+
+#if INCLUDE_vTaskPrioritySet
+    /**
+     * @brief Set the priority of all the tasks in the group.
+     * @param priority_ The TaskPriority to give the tasks.
+     */
+    void priority(TaskPriority priority_) {
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            tasks[i]->priority(priority_);
+        }
+        xTaskResumeAll();
+    }
+#endif
+
+    /**
+     * @brief Notify all the tasks in the group.
+     * @return The number of tasks successfully notified.
+     */
+    unsigned notify(uint32_t value, eNotifyAction act) {
+        unsigned notified = 0;
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            if(tasks[i]->notify(value, act)) notified++;
+        }
+        xTaskResumeAll();
+        return notified;
+    }
+    /**
+     * @brief Give a notification to all the tasks in the group.
+     */
+    void give() {
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            tasks[i]->give();
+        }
+        xTaskResumeAll();
+    }
+#if FREERTOS_VERSION_ALL >= 10'004'000
+    /**
+     * @brief Notify all the tasks in the group, on a given notification index.
+     * @return The number of tasks successfully notified.
+     */
+    unsigned notifyIndex(UBaseType_t idx, uint32_t value, eNotifyAction act) {
+        unsigned notified = 0;
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            if(tasks[i]->notifyIndex(idx, value, act)) notified++;
+        }
+        xTaskResumeAll();
+        return notified;
+    }
+    /**
+     * @brief Give a notification to all the tasks in the group, on a given notification index.
+     */
+    void giveIndex(UBaseType_t idx) {
+        vTaskSuspendAll();
+        for(unsigned i = 0; i < count; ++i) {
+            if(!tasks[i]->getTaskHandle()) continue;
+            tasks[i]->giveIndex(idx);
+        }
+        xTaskResumeAll();
+    }
+#endif
+
+private:
+    TaskBase**  tasks;
+    unsigned    capacity;
+    unsigned    count;
+
+#if __cplusplus < 201101L
+    TaskGroupBase(TaskGroupBase const&);      ///< We are not copyable.
+    void operator =(TaskGroupBase const&);  ///< We are not assignable.
+#else
+    TaskGroupBase(TaskGroupBase const&) = delete;      ///< We are not copyable.
+    void operator =(TaskGroupBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Bulk Control of a Group of Tasks.
+ *
+ * Example Usage:
+ * @code
+ * TaskGroup<8> logging;
+ * logging.add(logWriter);
+ * logging.add(logUploader);
+ *
+ * // Entering low power mode
+ * logging.suspend();
+ * @endcode
+ *
+ * @tparam maxTasks The most tasks the group can hold.
+ * @ingroup FreeRTOSCpp
+ */
+template<unsigned maxTasks> class TaskGroup : public TaskGroupBase {
+    static_assert(maxTasks > 0, "TaskGroup needs room for a task");
+public:
+    TaskGroup() : TaskGroupBase(storage, maxTasks) {}
+private:
+    TaskBase*   storage[maxTasks];
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_TASKGROUP_H_ */
@@ -0,0 +1,125 @@
+/**
+ * @file Tasklet.cpp
+ * @brief Tasklets, deferred work items run by a shared task
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "Tasklet.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+Tasklet::~Tasklet() {
+    taskENTER_CRITICAL();
+    if(pending) {
+        runner.unlink(this);
+        pending = false;
+    }
+    taskEXIT_CRITICAL();
+}
+
+bool Tasklet::schedule() {
+    bool scheduled = false;
+    taskENTER_CRITICAL();
+    if(!pending) {
+        pending = true;
+        runner.append(this);
+        scheduled = true;
+    }
+    taskEXIT_CRITICAL();
+    if(scheduled) runner.wake();
+    return scheduled;
+}
+
+bool Tasklet::schedule_ISR(portBASE_TYPE& waswoken) {
+    bool scheduled = false;
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    if(!pending) {
+        pending = true;
+        runner.append(this);
+        scheduled = true;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    if(scheduled) runner.wake_ISR(waswoken);
+    return scheduled;
+}
+
+void TaskletRunnerBase::append(Tasklet* tasklet) {
+    tasklet->link = nullptr;
+    if(tail) {
+        tail->link = tasklet;
+    } else {
+        head = tasklet;
+    }
+    tail = tasklet;
+}
+
+void TaskletRunnerBase::unlink(Tasklet* tasklet) {
+    Tasklet* prev = nullptr;
+    for(Tasklet* node = head; node; prev = node, node = node->link) {
+        if(node == tasklet) {
+            if(prev) {
+                prev->link = node->link;
+            } else {
+                head = node->link;
+            }
+            if(tail == node) tail = prev;
+            break;
+        }
+    }
+}
+
+bool TaskletRunnerBase::runBatch() {
+    // Take the whole list, anything scheduled from here on goes in the next batch.
+    taskENTER_CRITICAL();
+    Tasklet* batch = head;
+    head = tail = nullptr;
+    taskEXIT_CRITICAL();
+
+    if(!batch) return false;
+    batches++;
+    while(batch) {
+        Tasklet* tasklet = batch;
+        taskENTER_CRITICAL();
+        batch = tasklet->link;
+        tasklet->link = nullptr;
+        tasklet->pending = false;
+        taskEXIT_CRITICAL();
+        runs++;
+        tasklet->run();
+    }
+    return true;
+}
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
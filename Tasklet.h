@@ -0,0 +1,271 @@
+/**
+ * @file Tasklet.h
+ * @brief Tasklets, deferred work items run by a shared task
+ *
+ * A Tasklet is a statically allocated work item that can be scheduled from a task or
+ * an ISR to be run later by a TaskletRunner. This allows short pieces of work to be
+ * deferred out of an ISR or high priority task (like a "bottom half" handler) without
+ * needing a task for each of them.
+ *
+ * Typically a system will have a few TaskletRunners at different priorities, and each
+ * Tasklet is bound to the runner at the priority its work needs.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_TASKLET_H_
+#define FREERTOSPP_TASKLET_H_
+
+#include "FreeRTOScpp.h"
+#include "TaskCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+class TaskletRunnerBase;
+
+/**
+ * @brief Deferred Work Item.
+ *
+ * A Tasklet is scheduled with schedule() or schedule_ISR(), and will then have its
+ * function run once by the TaskletRunner it was bound to. Scheduling a Tasklet that
+ * is already pending does nothing, so bursts of events are merged into a single run.
+ * The Tasklet is no longer pending once its function starts, so it can be rescheduled
+ * while (or by) running, and will then run again in the next batch.
+ *
+ * Example Usage:
+ * @code
+ * TaskletRunner<256> highRunner("TaskletHi", TaskPrio_High);
+ *
+ * void processRx(void* parm);
+ * Tasklet rxTasklet(highRunner, &processRx);
+ *
+ * // In the ISR
+ * portBASE_TYPE woken = 0;
+ * rxTasklet.schedule_ISR(woken);
+ * portYIELD_FROM_ISR(woken);
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class Tasklet {
+    friend class TaskletRunnerBase;
+public:
+    /**
+     * @brief Constructor
+     * @param runner_ The TaskletRunner to run this Tasklet on.
+     * @param func_ The function to run.
+     * @param parm_ The parameter to pass to the function.
+     */
+    Tasklet(TaskletRunnerBase& runner_, void (*func_)(void*), void* parm_ = nullptr) :
+        runner(runner_), func(func_), parm(parm_), link(nullptr), pending(false) {}
+    /**
+     * @brief Destructor
+     *
+     * If still pending, the Tasklet is removed from its runner. It must not be destroyed
+     * while its runner is running the batch it is in.
+     */
+    virtual ~Tasklet();
+
+    /**
+     * @brief Schedule the Tasklet to be run.
+     * @return true if scheduled, false if it was already pending.
+     */
+    bool schedule();
+    /**
+     * @brief Schedule the Tasklet to be run, from an ISR.
+     * @param waswoken Flag to indicate if a task was woken that needs a yield.
+     * @return true if scheduled, false if it was already pending.
+     */
+    bool schedule_ISR(portBASE_TYPE& waswoken);
+
+    /**
+     * @brief Is the Tasklet waiting to be run.
+     */
+    bool isPending() const { return pending; }
+
+protected:
+    /**
+     * @brief The work of the Tasklet, by default calls the function given to the constructor.
+     */
+    virtual void run() { if(func) (*func)(parm); }
+
+private:
+    TaskletRunnerBase&  runner;
+    void              (*func)(void*);
+    void*               parm;
+    Tasklet*            link;       ///< Next Tasklet in the runner's list
+    bool                pending;
+
+#if __cplusplus < 201101L
+    Tasklet(Tasklet const&);      ///< We are not copyable.
+    void operator =(Tasklet const&);  ///< We are not assignable.
+#else
+    Tasklet(Tasklet const&) = delete;      ///< We are not copyable.
+    void operator =(Tasklet const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Tasklet with a virtual function to do the work.
+ *
+ * Derive from this and define run().
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class TaskletClass : public Tasklet {
+public:
+    TaskletClass(TaskletRunnerBase& runner_) : Tasklet(runner_, nullptr) {}
+protected:
+    virtual void run() override = 0;
+};
+
+/**
+ * @brief Tasklet that calls a member function of an object.
+ *
+ * @tparam T The class of the object.
+ * @ingroup FreeRTOSCpp
+ */
+template <class T> class TaskletMember : public TaskletClass {
+public:
+    TaskletMember(TaskletRunnerBase& runner_, T* obj_, void (T::*func_)()) :
+        TaskletClass(runner_),
+        obj(obj_),
+        func(func_)
+    {}
+protected:
+    virtual void run() override { (obj->*func)(); }
+private:
+    T* obj;
+    void (T::*func)();
+};
+
+/**
+ * @brief Runs scheduled Tasklets.
+ *
+ * Holds the FIFO list of pending Tasklets. Each wakeup of the runner takes the whole
+ * list as one batch and runs it in the order scheduled. Tasklets scheduled while a
+ * batch is running will be run in the next batch.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class TaskletRunnerBase {
+    friend class Tasklet;
+public:
+    TaskletRunnerBase() : head(nullptr), tail(nullptr), batches(0), runs(0) {}
+    virtual ~TaskletRunnerBase() {}
+
+    /**
+     * @brief Number of batches run.
+     */
+    uint32_t batchCount() const { return batches; }
+    /**
+     * @brief Number of Tasklets run.
+     */
+    uint32_t runCount() const { return runs; }
+
+protected:
+    /**
+     * @brief Run one batch of Tasklets.
+     * @return true if there were any Tasklets to run.
+     */
+    bool runBatch();
+
+    /// Wake the runner task to run a batch.
+    virtual void wake() = 0;
+    /// Wake the runner task to run a batch, from an ISR.
+    virtual void wake_ISR(portBASE_TYPE& waswoken) = 0;
+
+private:
+    /// Add to the list, must be in a critical section.
+    void append(Tasklet* tasklet);
+    /// Remove from the list, must be in a critical section.
+    void unlink(Tasklet* tasklet);
+
+    Tasklet*    head;
+    Tasklet*    tail;
+    uint32_t    batches;
+    uint32_t    runs;
+
+#if __cplusplus < 201101L
+    TaskletRunnerBase(TaskletRunnerBase const&);      ///< We are not copyable.
+    void operator =(TaskletRunnerBase const&);  ///< We are not assignable.
+#else
+    TaskletRunnerBase(TaskletRunnerBase const&) = delete;      ///< We are not copyable.
+    void operator =(TaskletRunnerBase const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+/**
+ * @brief Task to run Tasklets.
+ *
+ * @tparam stackDepth Size of the stack to give to the task, it needs to be big enough for
+ * all the Tasklets run on it.
+ *
+ * @ingroup FreeRTOSCpp
+ */
+template<uint32_t stackDepth>
+class TaskletRunner : public TaskClassS<stackDepth>, public TaskletRunnerBase {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param name The name of the task.
+     * @param priority_ The priority to run the Tasklets at.
+     * @param stackDepth_ Size of the stack for dynamically created tasks (stackDepth == 0)
+     */
+    TaskletRunner(char const* name, TaskPriority priority_, unsigned portSHORT stackDepth_ = 0) :
+        TaskClassS<stackDepth>(name, priority_, stackDepth_)
+    {
+        // API CHANGE: Most derived constructor needs to give if scheduler running.
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+            this->give();
+        }
+    }
+
+    void task() override {
+        while(1) {
+            // Run first, as Tasklets may have been scheduled before we started.
+            runBatch();
+            TaskBase::take();
+        }
+    }
+
+protected:
+    void wake() override { this->give(); }
+    void wake_ISR(portBASE_TYPE& waswoken) override { this->give_ISR(waswoken); }
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_TASKLET_H_ */
@@ -41,6 +41,9 @@
 #include "FreeRTOScpp.h"
 #include "FreeRTOS.h"
 #include "timers.h"
+#if FREERTOSCPP_USE_PERF_COUNTERS
+#include "PerfCounters.h"
+#endif
 
 #if FREERTOSCPP_USE_NAMESPACE
 namespace FreeRTOScpp {
@@ -83,32 +86,32 @@ public:
 	TickType_t	expiryTime() { return xTimerGetExpiryTime(timerHandle); }   // TODO Time_ms versions?
 	const char* name() { return pcTimerGetName(timerHandle); }
 	TickType_t  period() { return xTimerGetPeriod(timerHandle); }
-	bool		period(TickType_t period_, TickType_t wait = portMAX_DELAY) { configASSERT(period_ > 0); return xTimerChangePeriod(timerHandle, period_, wait);}
+	bool		period(TickType_t period_, TickType_t wait = portMAX_DELAY) { configASSERT(period_ > 0); return FREERTOSCPP_PERF_CHECK(xTimerChangePeriod(timerHandle, period_, wait), perfTimerCommandFail);}
 #if FREERTOSCPP_USE_CHRONO
-    bool        period(Time_ms period_, TickType_t wait = portMAX_DELAY) { configASSERT(ms2ticks(period_) > 0); return xTimerChangePeriod(timerHandle, ms2ticks(period_), wait);}
-    bool        period(Time_ms period_, Time_ms wait) { configASSERT(ms2ticks(period_) > 0); return xTimerChangePeriod(timerHandle, ms2ticks(period_), ms2ticks(wait));}
+    bool        period(Time_ms period_, TickType_t wait = portMAX_DELAY) { configASSERT(ms2ticks(period_) > 0); return FREERTOSCPP_PERF_CHECK(xTimerChangePeriod(timerHandle, ms2ticks(period_), wait), perfTimerCommandFail);}
+    bool        period(Time_ms period_, Time_ms wait) { configASSERT(ms2ticks(period_) > 0); return FREERTOSCPP_PERF_CHECK(xTimerChangePeriod(timerHandle, ms2ticks(period_), ms2ticks(wait)), perfTimerCommandFail);}
 #endif
-	bool		periodISR(TickType_t period_, portBASE_TYPE& waswoken) { configASSERT(period_ > 0); return xTimerChangePeriodFromISR(timerHandle, period_, &waswoken); }
+	bool		periodISR(TickType_t period_, portBASE_TYPE& waswoken) { configASSERT(period_ > 0); return FREERTOSCPP_PERF_CHECK(xTimerChangePeriodFromISR(timerHandle, period_, &waswoken), perfTimerCommandFail); }
 #if FREERTOSCPP_USE_CHRONO
-    bool        periodISR(Time_ms period_, portBASE_TYPE& waswoken) { configASSERT(ms2ticks(period_) > 0); return xTimerChangePeriodFromISR(timerHandle, ms2ticks(period_), &waswoken); }
+    bool        periodISR(Time_ms period_, portBASE_TYPE& waswoken) { configASSERT(ms2ticks(period_) > 0); return FREERTOSCPP_PERF_CHECK(xTimerChangePeriodFromISR(timerHandle, ms2ticks(period_), &waswoken), perfTimerCommandFail); }
 #endif
-	bool		reset(TickType_t wait = portMAX_DELAY) { return xTimerReset(timerHandle, wait); }
+	bool		reset(TickType_t wait = portMAX_DELAY) { return FREERTOSCPP_PERF_CHECK(xTimerReset(timerHandle, wait), perfTimerCommandFail); }
 #if FREERTOSCPP_USE_CHRONO
-    bool        reset(Time_ms wait) { return xTimerReset(timerHandle, ms2ticks(wait)); }
+    bool        reset(Time_ms wait) { return FREERTOSCPP_PERF_CHECK(xTimerReset(timerHandle, ms2ticks(wait)), perfTimerCommandFail); }
 #endif
-	bool		resetISR(portBASE_TYPE& waswoken) { return xTimerResetFromISR(timerHandle, &waswoken); }
+	bool		resetISR(portBASE_TYPE& waswoken) { return FREERTOSCPP_PERF_CHECK(xTimerResetFromISR(timerHandle, &waswoken), perfTimerCommandFail); }
 
-	bool		start(TickType_t wait = portMAX_DELAY) { return xTimerStart(timerHandle, wait); }
+	bool		start(TickType_t wait = portMAX_DELAY) { return FREERTOSCPP_PERF_CHECK(xTimerStart(timerHandle, wait), perfTimerCommandFail); }
 #if FREERTOSCPP_USE_CHRONO
-    bool        start(Time_ms wait) { return xTimerStart(timerHandle, ms2ticks(wait)); }
+    bool        start(Time_ms wait) { return FREERTOSCPP_PERF_CHECK(xTimerStart(timerHandle, ms2ticks(wait)), perfTimerCommandFail); }
 #endif
-	bool		startISR(portBASE_TYPE& waswoken) { return xTimerStartFromISR(timerHandle, &waswoken); }
+	bool		startISR(portBASE_TYPE& waswoken) { return FREERTOSCPP_PERF_CHECK(xTimerStartFromISR(timerHandle, &waswoken), perfTimerCommandFail); }
 
-	bool		stop(TickType_t wait = portMAX_DELAY) { return xTimerStop(timerHandle, wait); }
+	bool		stop(TickType_t wait = portMAX_DELAY) { return FREERTOSCPP_PERF_CHECK(xTimerStop(timerHandle, wait), perfTimerCommandFail); }
 #if FREERTOSCPP_USE_CHRONO
-    bool        stop(Time_ms wait) { return xTimerStop(timerHandle, ms2ticks(wait)); }
+    bool        stop(Time_ms wait) { return FREERTOSCPP_PERF_CHECK(xTimerStop(timerHandle, ms2ticks(wait)), perfTimerCommandFail); }
 #endif
-	bool		stopISR(portBASE_TYPE& waswoken) { return xTimerStopFromISR(timerHandle, &waswoken); }
+	bool		stopISR(portBASE_TYPE& waswoken) { return FREERTOSCPP_PERF_CHECK(xTimerStopFromISR(timerHandle, &waswoken), perfTimerCommandFail); }
 
 #if FREERTOS_VERSION >= 10'002'000
 	void 		reload(bool reload) { vTimerSetReloadMode( timerHandle, reload); }
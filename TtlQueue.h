@@ -0,0 +1,237 @@
+/**
+ * @file TtlQueue.h
+ * @brief Queue with Per-Item Time To Live
+ *
+ * A Queue whose items are time stamped when added, and dropped instead of returned
+ * if they have waited longer than their time to live, so work that is no longer useful
+ * after a stall doesn't delay the recovery.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_TTLQUEUE_H_
+#define FREERTOSPP_TTLQUEUE_H_
+
+#include "FreeRTOScpp.h"
+#include "QueueCPP.h"
+#include "CallBack.h"
+#include "Atomic.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+/**
+ * @brief Queue with Per-Item Time To Live.
+ *
+ * Each item is stored with the tick it was added and its time to live. When an item
+ * reaches the head of the queue, and has been in the queue longer than its TTL, it is
+ * dropped (and counted) rather than returned, and the pop continues with the next item.
+ *
+ * Items are given the queue's default TTL, unless the producer gives one with the item.
+ *
+ * Example Usage:
+ * @code
+ * TtlQueue<Command, 8> commands(pdMS_TO_TICKS(200));
+ *
+ * commands.add(move);                         // Stale after 200 ms
+ * commands.add(abort, 0, pdMS_TO_TICKS(5000)); // Stale after 5 s
+ * @endcode
+ *
+ * @tparam T The type of object to be placed on the queue.
+ * Note also, this type needs to be trivially copyable, as with Queue.
+ * @tparam queueLength The number of elements to reserve space for in the queue.
+ * @ingroup FreeRTOSCpp
+ */
+template<class T, unsigned queueLength> class TtlQueue {
+    static_assert(queueLength > 0, "TtlQueue needs a fixed length");
+public:
+    /**
+     * @brief Constructor.
+     * @param maxAge_ The default time to live for items, in ticks.
+     * @param dropHandler_ If not null, called with each item dropped (from the popping task).
+     * @param name The name to register the Queue with.
+     */
+    TtlQueue(TickType_t maxAge_, CallBack<void, T const&>* dropHandler_ = nullptr, char const* name = nullptr) :
+        queue(name),
+        defaultTtl(maxAge_),
+        dropHandler(dropHandler_),
+        droppedCount(0)
+    {}
+
+    /**
+     * @brief Push an item onto the Queue.
+     * Puts an item onto the Queue so it will be the next item to remove.
+     * @param item The item to put on the Queue.
+     * @param time How long to wait for room if Queue is full.
+     * @param ttl Time to live for this item, 0 for the default.
+     * @return True if successful
+     */
+    bool push(T const& item, TickType_t time = portMAX_DELAY, TickType_t ttl = 0) {
+        Entry entry = { item, xTaskGetTickCount(), ttl ? ttl : defaultTtl };
+        return queue.push(entry, time);
+    }
+    /**
+     * @brief add an item at end of the Queue.
+     * Puts an item onto the Queue so it will be the last item to remove.
+     * @param item The item to put on the Queue.
+     * @param time How long to wait for room if Queue is full.
+     * @param ttl Time to live for this item, 0 for the default.
+     * @return True if successful
+     */
+    bool add(T const& item, TickType_t time = portMAX_DELAY, TickType_t ttl = 0) {
+        Entry entry = { item, xTaskGetTickCount(), ttl ? ttl : defaultTtl };
+        return queue.add(entry, time);
+    }
+    /**
+     * @brief Get an item from the Queue.
+     * Gets the first item from the Queue that hasn't expired, dropping those that have.
+     * @param var Variable to place the item
+     * @param time How long to wait for an item to be available.
+     * @return True if an item returned.
+     */
+    bool pop(T& var, TickType_t time = portMAX_DELAY) {
+        TickType_t start = xTaskGetTickCount();
+        TickType_t remaining = time;
+        Entry entry;
+        while(queue.pop(entry, remaining)) {
+            TickType_t now = xTaskGetTickCount();
+            if(!expired(entry, now)) {
+                var = entry.item;
+                return true;
+            }
+            drop(entry);
+            if(time != portMAX_DELAY) {
+                TickType_t used = now - start;
+                remaining = used < time ? time - used : 0;
+            }
+        }
+        return false;
+    }
+#if FREERTOSCPP_USE_CHRONO
+    bool push(T const& item, Time_ms time, Time_ms ttl) { return push(item, ms2ticks(time), ms2ticks(ttl)); }
+    bool push(T const& item, Time_ms time) { return push(item, ms2ticks(time)); }
+    bool add(T const& item, Time_ms time, Time_ms ttl) { return add(item, ms2ticks(time), ms2ticks(ttl)); }
+    bool add(T const& item, Time_ms time) { return add(item, ms2ticks(time)); }
+    bool pop(T& var, Time_ms time) { return pop(var, ms2ticks(time)); }
+#endif
+
+    /**
+     * @brief add an item at end of the Queue.
+     *
+     * Note: Interrupt service routines should only call _ISR routines.
+     * @param item The item to put on the Queue.
+     * @param waswoken Flag variable to determine if context switch is needed.
+     * @param ttl Time to live for this item, 0 for the default.
+     * @return True if successful
+     */
+    bool add_ISR(T const& item, portBASE_TYPE& waswoken, TickType_t ttl = 0) {
+        Entry entry = { item, xTaskGetTickCountFromISR(), ttl ? ttl : defaultTtl };
+        return queue.add_ISR(entry, waswoken);
+    }
+    /**
+     * @brief Get an item from the Queue.
+     *
+     * Expired items are dropped, but the drop handler is not called from the ISR.
+     *
+     * Note: Interrupt service routines should only call _ISR routines.
+     * @param var Variable to place the item
+     * @param waswoken Flag variable to determine if context switch is needed.
+     * @return True if an item returned.
+     */
+    bool pop_ISR(T& var, portBASE_TYPE& waswoken) {
+        Entry entry;
+        while(queue.pop_ISR(entry, waswoken)) {
+            if(!expired(entry, xTaskGetTickCountFromISR())) {
+                var = entry.item;
+                return true;
+            }
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get number of items in the Queue, including any expired ones not yet dropped.
+     */
+    unsigned waiting() const { return queue.waiting(); }
+    /**
+     * @brief Return number of spaces available in Queue
+     */
+    unsigned available() const { return queue.available(); }
+
+    /**
+     * @brief Number of items dropped for being past their TTL.
+     */
+    uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+    /**
+     * @brief The default time to live.
+     */
+    TickType_t maxAge() const { return defaultTtl; }
+    /**
+     * @brief Change the default time to live, for items added after.
+     */
+    void maxAge(TickType_t maxAge_) { defaultTtl = maxAge_; }
+
+private:
+    struct Entry {
+        T           item;
+        TickType_t  stamp;      ///< Tick the item was added.
+        TickType_t  ttl;
+    };
+
+    static bool expired(Entry const& entry, TickType_t now) {
+        return static_cast<TickType_t>(now - entry.stamp) > entry.ttl;
+    }
+
+    void drop(Entry const& entry) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        if(dropHandler) dropHandler->callback(entry.item);
+    }
+
+    Queue<Entry, queueLength>   queue;
+    TickType_t                  defaultTtl;
+    CallBack<void, T const&>*   dropHandler;
+    Atomic<uint32_t, Atomic_IsrSafe> droppedCount;  ///< Counted from pop_ISR() and the tasks
+
+#if __cplusplus < 201101L
+    TtlQueue(TtlQueue const&);      ///< We are not copyable.
+    void operator =(TtlQueue const&);  ///< We are not assignable.
+#else
+    TtlQueue(TtlQueue const&) = delete;      ///< We are not copyable.
+    void operator =(TtlQueue const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_TTLQUEUE_H_ */
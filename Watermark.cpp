@@ -0,0 +1,107 @@
+/**
+ * @file Watermark.cpp
+ * @brief High/Low Watermark Monitor for Queues and Buffers
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#include "Watermark.h"
+#include "EventCPP.h"
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+void Watermark::signal() {
+    // Only one signaller at a time, any others have already changed the state it checks.
+    taskENTER_CRITICAL();
+    bool busy = signalling;
+    signalling = true;
+    taskEXIT_CRITICAL();
+    if(busy) return;
+
+    while(1) {
+        taskENTER_CRITICAL();
+        bool toHigh = above;
+        bool done = toHigh == reported;
+        if(done) signalling = false;
+        taskEXIT_CRITICAL();
+        if(done) return;
+
+        reported = toHigh;
+        changed(toHigh);
+    }
+}
+
+void Watermark::signal_ISR(portBASE_TYPE& waswoken) {
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    bool busy = signalling;
+    signalling = true;
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    if(busy) return;
+
+    while(1) {
+        saved = taskENTER_CRITICAL_FROM_ISR();
+        bool toHigh = above;
+        bool done = toHigh == reported;
+        if(done) signalling = false;
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        if(done) return;
+
+        reported = toHigh;
+        changed_ISR(toHigh, waswoken);
+    }
+}
+
+void Watermark::changed(bool toHigh) {
+    if(group) {
+        if(toHigh) {
+            group->set(bits);
+        } else {
+            group->clear(bits);
+        }
+    }
+    if(handler) handler->callback(toHigh);
+}
+
+void Watermark::changed_ISR(bool toHigh, portBASE_TYPE& waswoken) {
+    if(group) {
+        if(toHigh) {
+            group->set_ISR(bits, waswoken);
+        } else {
+            group->clear_ISR(bits);
+        }
+    }
+    if(handler) handler->callback(toHigh);
+}
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file Watermark.h
+ * @brief High/Low Watermark Monitor for Queues and Buffers
+ *
+ * Lets a producer find out that the consumer is falling behind when the fill level
+ * crosses a high watermark, rather than when an add finally blocks or fails.
+ *
+ * @copyright (c) 2026 Richard Damon
+ * @author Richard Damon <richard.damon@gmail.com>
+ * @parblock
+ * MIT License:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * It is requested (but not required by license) that any bugs found or
+ * improvements made be shared, preferably to the author.
+ * @endparblock
+ *
+ * @ingroup FreeRTOSCpp
+ */
+
+#ifndef FREERTOSPP_WATERMARK_H_
+#define FREERTOSPP_WATERMARK_H_
+
+#include "FreeRTOScpp.h"
+#include "CallBack.h"
+#include "event_groups.h"
+#include <stddef.h>
+
+#if FREERTOSCPP_USE_NAMESPACE
+namespace FreeRTOScpp {
+#endif
+
+class EventGroup;
+
+/**
+ * @brief High/Low Watermark with Hysteresis.
+ *
+ * Attached to a Queue, StreamBuffer or MessageBuffer with setWatermark(), it is given the
+ * fill level after each operation that changes it. When the level rises to high or above,
+ * the watermark goes high, and when it then falls to low or below, it goes low again, so
+ * the level has to move by the hysteresis between the two before it is reported again.
+ *
+ * Each crossing calls the handler (with true going high, false going low) and/or sets the
+ * event bits going high and clears them going low. Between crossings an update is just a
+ * compare.
+ *
+ * The handler is called in the context of the operation that caused the crossing (or of
+ * another operation racing with it), for the _ISR operations that is the interrupt, and
+ * setting bits from an ISR is deferred to the timer task (as EventGroup::set_ISR()).
+ *
+ * Racing operations are resolved by taking the level again inside a critical section
+ * when a crossing is seen, and by only one caller at a time doing the signalling, which
+ * keeps going until the signalled state matches the latest one.
+ *
+ * The levels are in the units of the object monitored, items for a Queue, and bytes for
+ * StreamBuffers and MessageBuffers (for MessageBuffers, including the length word stored
+ * with each message).
+ *
+ * Example Usage:
+ * @code
+ * EventGroup flowControl;
+ * Watermark rxBacklog(12, 4, flowControl, 0x01);
+ * Queue<Packet, 16> rxQueue;
+ *
+ * rxQueue.setWatermark(&rxBacklog);
+ * @endcode
+ *
+ * @ingroup FreeRTOSCpp
+ */
+class Watermark {
+public:
+    /**
+     * @brief Constructor
+     * @param high_ Level at or above which the watermark goes high.
+     * @param low_ Level at or below which the watermark goes low, should be less than high_.
+     * @param handler_ Called on each crossing.
+     */
+    Watermark(size_t high_, size_t low_, CallBack<void, bool>* handler_) :
+        highLevel(high_), lowLevel(low_), handler(handler_), group(nullptr), bits(0),
+        above(false), reported(false), signalling(false), crossCount(0) {}
+    /**
+     * @brief Constructor
+     * @param high_ Level at or above which the watermark goes high.
+     * @param low_ Level at or below which the watermark goes low, should be less than high_.
+     * @param group_ Event Group to signal crossings with.
+     * @param bits_ Event bits set when going high, and cleared when going low.
+     * @param handler_ Optional handler also called on each crossing.
+     */
+    Watermark(size_t high_, size_t low_, EventGroup& group_, EventBits_t bits_, CallBack<void, bool>* handler_ = nullptr) :
+        highLevel(high_), lowLevel(low_), handler(handler_), group(&group_), bits(bits_),
+        above(false), reported(false), signalling(false), crossCount(0) {}
+    virtual ~Watermark() {}
+
+    /**
+     * @brief Report a new fill level.
+     * @param level The new fill level, which must be current, see updateFrom().
+     */
+    void update(size_t level) { updateFrom([level] { return level; }); }
+    /**
+     * @brief Report a new fill level from an ISR.
+     *
+     * Note: Interrupt service routines should only call _ISR routines.
+     * @param level The new fill level.
+     * @param waswoken Flag variable to determine if context switch is needed.
+     */
+    void update_ISR(size_t level, portBASE_TYPE& waswoken) { updateFrom_ISR([level] { return level; }, waswoken); }
+
+    /**
+     * @brief Report the fill level after an operation.
+     *
+     * Called by the objects the watermark is attached to. If the level looks to have
+     * crossed, it is read again in a critical section, so a stale level from an operation
+     * racing with another can't leave the watermark in the wrong state.
+     *
+     * @param sample Function object returning the current level, callable in a critical section.
+     */
+    template<class Sampler> void updateFrom(Sampler sample) {
+        if(!crossed(sample())) return;      // The common case, just a compare.
+        taskENTER_CRITICAL();
+        bool changed = crossed(sample());
+        if(changed) {
+            above = !above;
+            crossCount++;
+        }
+        taskEXIT_CRITICAL();
+        if(changed) signal();
+    }
+    /**
+     * @brief Report the fill level after an operation, from an ISR.
+     *
+     * @param sample Function object returning the current level, callable in a critical section.
+     * @param waswoken Flag variable to determine if context switch is needed.
+     */
+    template<class Sampler> void updateFrom_ISR(Sampler sample, portBASE_TYPE& waswoken) {
+        if(!crossed(sample())) return;
+        UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+        bool changed = crossed(sample());
+        if(changed) {
+            above = !above;
+            crossCount++;
+        }
+        taskEXIT_CRITICAL_FROM_ISR(saved);
+        if(changed) signal_ISR(waswoken);
+    }
+
+    /**
+     * @brief Change the levels.
+     *
+     * Takes effect on the next update.
+     */
+    void levels(size_t high_, size_t low_) { highLevel = high_; lowLevel = low_; }
+    size_t high() const { return highLevel; }
+    size_t low() const { return lowLevel; }
+    /**
+     * @brief Is the watermark currently high.
+     */
+    bool isHigh() const { return above; }
+    /**
+     * @brief Number of crossings, in either direction.
+     */
+    uint32_t crossings() const { return crossCount; }
+
+protected:
+    /// Signal a change of state, by default to the event group and handler.
+    virtual void changed(bool toHigh);
+    /// Signal a change of state from an ISR.
+    virtual void changed_ISR(bool toHigh, portBASE_TYPE& waswoken);
+
+private:
+    /// Is level across the threshold for the current state.
+    bool crossed(size_t level) const { return above ? level <= lowLevel : level >= highLevel; }
+    /// Signal state changes until the signalled state matches the current one.
+    void signal();
+    void signal_ISR(portBASE_TYPE& waswoken);
+
+    size_t                  highLevel;
+    size_t                  lowLevel;
+    CallBack<void, bool>*   handler;
+    EventGroup*             group;
+    EventBits_t             bits;
+    volatile bool           above;
+    bool                    reported;       ///< State last signalled.
+    bool                    signalling;     ///< A caller is in signal().
+    uint32_t                crossCount;
+
+#if __cplusplus < 201101L
+    Watermark(Watermark const&);      ///< We are not copyable.
+    void operator =(Watermark const&);  ///< We are not assignable.
+#else
+    Watermark(Watermark const&) = delete;      ///< We are not copyable.
+    void operator =(Watermark const&) = delete;  ///< We are not assignable.
+#endif // __cplusplus
+};
+
+#if FREERTOSCPP_USE_NAMESPACE
+}   // namespace FreeRTOScpp
+#endif
+
+#endif /* FREERTOSPP_WATERMARK_H_ */